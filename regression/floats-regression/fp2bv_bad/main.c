@@ -0,0 +1,13 @@
+#include <assert.h>
+
+float nondet_float();
+
+int main()
+{
+  float x = nondet_float();
+  __ESBMC_assume(x >= 1.0f && x <= 2.0f);
+
+  float y = x + 0.5f;
+  assert(y < 2.5f);
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <assert.h>
+#include <fenv.h>
+
+float nondet_float();
+double nondet_double();
+int nondet_int();
+unsigned int nondet_uint();
+
+int main()
+{
+  int i = nondet_int(), j = nondet_int();
+  unsigned int u = nondet_uint();
+  __ESBMC_assume(i == 16777217 && j == -16777219 && u == 4294967295u);
+
+  // Integers with more bits than a float's significand round to even
+  assert((float) i == 0x1p+24f);
+  assert((float) j == -0x1.000004p+24f);
+  assert((float) u == 0x1p+32f);
+
+  // Floats truncate towards zero
+  float f = nondet_float(), g = nondet_float();
+  __ESBMC_assume(f == 2.75f && g == -2.75f);
+  assert((int) f == 2 && (int) g == -2);
+  assert((unsigned int) f == 2u);
+  assert((long long) (f * 0x1p40f) == 11LL << 38);
+
+  // Between float and double
+  double d = nondet_double();
+  __ESBMC_assume(d == 0.1);
+  assert((float) d == 0x1.99999ap-4f);
+  assert((double) (float) d == 0x1.99999ap-4);
+  assert((double) f == 2.75);
+
+  // Under other rounding modes
+  fesetround(FE_UPWARD);
+  assert((float) i == 0x1.000002p+24f);
+  fesetround(FE_TOWARDZERO);
+  assert((float) d == 0x1.999998p-4f);
+  return 0;
+}
@@ -0,0 +1,36 @@
+#include <assert.h>
+#include <fenv.h>
+#include <float.h>
+#include <math.h>
+
+float nondet_float();
+
+// The library handles special values before reaching this, so call it
+// directly to check that the lowering handles them too
+float __ESBMC_fmaf(float x, float y, float z);
+
+int main()
+{
+  float a = nondet_float(), big = nondet_float(), one = nondet_float();
+  __ESBMC_assume(a == 0x1.001p+0f && big == FLT_MAX && one == 1.0f);
+
+  // a * a is 0x1.002p+0 plus 0x1p-24, which only a single rounding keeps
+  float p = a * a;
+  assert(p == 0x1.002p+0f);
+  assert(a * a - p == 0.0f);
+  assert(__ESBMC_fmaf(a, a, -p) == 0x1p-24f);
+  assert(fmaf(a, a, -p) == 0x1p-24f);
+
+  fesetround(FE_UPWARD);
+  assert(__ESBMC_fmaf(a, a, 0.0f) == 0x1.002002p+0f);
+  fesetround(FE_TONEAREST);
+
+  // The product doesn't overflow before the addition
+  assert(__ESBMC_fmaf(big, 2.0f, -big) == big);
+
+  float inf = big * 2.0f;
+  assert(isnan(__ESBMC_fmaf(inf, 0.0f, one)));
+  assert(isnan(__ESBMC_fmaf(inf, one, -inf)));
+  assert(__ESBMC_fmaf(inf, one, big) == inf);
+  return 0;
+}
@@ -0,0 +1,33 @@
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+float nondet_float();
+
+int main()
+{
+  float inf = nondet_float(), big = nondet_float(), zero = nondet_float();
+  __ESBMC_assume(inf == INFINITY && big == FLT_MAX);
+  __ESBMC_assume(zero == 0.0f && !signbit(zero));
+
+  // Overflow
+  assert(big * 2.0f == inf);
+  assert(big + big == inf);
+  assert(-big - big == -inf);
+  assert(inf > big);
+
+  // Invalid operations, and how NaN compares and propagates
+  float nan = inf - inf;
+  assert(isnan(nan) && nan != nan);
+  assert(!(nan < 1.0f) && !(nan > 1.0f) && !(nan == 1.0f));
+  assert(isnan(nan + 1.0f) && isnan(nan * zero));
+  assert(isnan(zero * inf) && isnan(zero / zero) && isnan(inf / inf));
+
+  // Signed zeroes and division by them
+  assert(zero == -zero);
+  assert(1.0f / zero == inf && -1.0f / zero == -inf);
+  assert(1.0f / -zero == -inf);
+  assert(1.0f / inf == 0.0f && !signbit(1.0f / inf));
+  assert(signbit(-1.0f / inf));
+  return 0;
+}
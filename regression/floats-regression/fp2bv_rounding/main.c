@@ -0,0 +1,55 @@
+#include <assert.h>
+#include <fenv.h>
+
+float nondet_float();
+int nondet_int();
+
+int main()
+{
+  float one = nondet_float(), tiny = nondet_float(), three = nondet_float();
+  __ESBMC_assume(one == 1.0f && tiny == 0x1p-24f && three == 3.0f);
+
+  int mode = nondet_int();
+  __ESBMC_assume(mode == FE_TONEAREST || mode == FE_DOWNWARD ||
+                 mode == FE_UPWARD || mode == FE_TOWARDZERO);
+  fesetround(mode);
+
+  // Halfway between two floats, below and above one, and not halfway
+  float even = one + tiny;
+  float neg = -one - tiny;
+  float odd = one + three * tiny;
+  float third = one / three;
+
+  if(mode == FE_TONEAREST)
+  {
+    assert(even == 1.0f);
+    assert(neg == -1.0f);
+    assert(odd == 0x1.000004p+0f);
+    assert(third == 0x1.555556p-2f);
+  }
+
+  if(mode == FE_DOWNWARD)
+  {
+    assert(even == 1.0f);
+    assert(neg == -0x1.000002p+0f);
+    assert(odd == 0x1.000002p+0f);
+    assert(third == 0x1.555554p-2f);
+  }
+
+  if(mode == FE_UPWARD)
+  {
+    assert(even == 0x1.000002p+0f);
+    assert(neg == -1.0f);
+    assert(odd == 0x1.000004p+0f);
+    assert(third == 0x1.555556p-2f);
+  }
+
+  if(mode == FE_TOWARDZERO)
+  {
+    assert(even == 1.0f);
+    assert(neg == -1.0f);
+    assert(odd == 0x1.000002p+0f);
+    assert(third == 0x1.555554p-2f);
+  }
+  return 0;
+}
@@ -0,0 +1,20 @@
+#include <assert.h>
+#include <fenv.h>
+
+float nondet_float();
+int nondet_int();
+
+int main()
+{
+  float one = nondet_float(), tiny = nondet_float();
+  __ESBMC_assume(one == 1.0f && tiny == 0x1p-24f);
+
+  int mode = nondet_int();
+  __ESBMC_assume(mode == FE_TONEAREST || mode == FE_DOWNWARD ||
+                 mode == FE_UPWARD || mode == FE_TOWARDZERO);
+  fesetround(mode);
+
+  // Only rounding upward breaks the tie away from one
+  assert(one + tiny == 1.0f);
+  return 0;
+}
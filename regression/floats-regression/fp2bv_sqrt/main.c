@@ -0,0 +1,37 @@
+#include <assert.h>
+#include <fenv.h>
+#include <math.h>
+
+float nondet_float();
+
+// The library handles special values before reaching this, so call it
+// directly to check that the lowering handles them too
+float __ESBMC_sqrtf(float n);
+
+int main()
+{
+  float four = nondet_float(), two = nondet_float(), tiny = nondet_float();
+  __ESBMC_assume(four == 4.0f && two == 2.0f && tiny == 0x1p-148f);
+
+  assert(__ESBMC_sqrtf(four) == 2.0f);
+  assert(__ESBMC_sqrtf(two) == 0x1.6a09e6p+0f);
+  assert(__ESBMC_sqrtf(tiny) == 0x1p-74f);
+
+  fesetround(FE_UPWARD);
+  assert(__ESBMC_sqrtf(two) == 0x1.6a09e8p+0f);
+  fesetround(FE_TOWARDZERO);
+  assert(__ESBMC_sqrtf(two) == 0x1.6a09e6p+0f);
+  fesetround(FE_TONEAREST);
+
+  float negz = -(four - four);
+  assert(__ESBMC_sqrtf(negz) == 0.0f && signbit(__ESBMC_sqrtf(negz)));
+  assert(isnan(__ESBMC_sqrtf(-four)));
+  assert(isinf(__ESBMC_sqrtf(four / 0.0f)));
+  assert(isnan(__ESBMC_sqrtf(-four / 0.0f)));
+
+  float x = nondet_float();
+  __ESBMC_assume(x >= 1.0f && x <= 4.0f);
+  float r = sqrtf(x);
+  assert(r >= 1.0f && r <= 2.0f);
+  return 0;
+}
@@ -0,0 +1,27 @@
+#include <assert.h>
+#include <math.h>
+
+float nondet_float();
+
+int main()
+{
+  float min_normal = nondet_float(), min_sub = nondet_float();
+  float two = nondet_float();
+  __ESBMC_assume(min_normal == 0x1p-126f && min_sub == 0x1p-149f &&
+                 two == 2.0f);
+
+  float half = min_normal / two;
+  assert(half == 0x1p-127f && !isnormal(half));
+  assert(half * two == min_normal);
+  assert(min_normal - 0x1.000002p-126f == -min_sub);
+
+  // Ties at the bottom of the range go to even, down to zero
+  assert(min_sub + min_sub == 0x1p-148f);
+  assert(min_sub * 1.5f == 0x1p-148f);
+  assert(min_sub * 2.5f == 0x1p-148f);
+  assert(min_sub / two == 0.0f);
+
+  // And back up into the normal range
+  assert(min_sub * 0x1p100f == 0x1p-49f);
+  return 0;
+}
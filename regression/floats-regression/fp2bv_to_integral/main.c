@@ -0,0 +1,43 @@
+#include <assert.h>
+#include <fenv.h>
+#include <math.h>
+
+float nondet_float();
+
+// The library handles special values before reaching this, so call it
+// directly to check that the lowering handles them too
+float __ESBMC_nearbyintf(float f);
+
+int main()
+{
+  float a = nondet_float(), b = nondet_float(), c = nondet_float();
+  float d = nondet_float(), big = nondet_float();
+  __ESBMC_assume(a == 2.5f && b == -2.5f && c == 12.9f && d == -0.4f &&
+                 big == 0x1.000002p+30f);
+
+  fesetround(FE_TONEAREST);
+  assert(__ESBMC_nearbyintf(a) == 2.0f && __ESBMC_nearbyintf(b) == -2.0f);
+  assert(__ESBMC_nearbyintf(c) == 13.0f);
+  assert(__ESBMC_nearbyintf(d) == 0.0f && signbit(__ESBMC_nearbyintf(d)));
+
+  fesetround(FE_DOWNWARD);
+  assert(__ESBMC_nearbyintf(a) == 2.0f && __ESBMC_nearbyintf(b) == -3.0f);
+  assert(__ESBMC_nearbyintf(c) == 12.0f);
+  assert(__ESBMC_nearbyintf(d) == -1.0f);
+
+  fesetround(FE_UPWARD);
+  assert(__ESBMC_nearbyintf(a) == 3.0f && __ESBMC_nearbyintf(b) == -2.0f);
+  assert(__ESBMC_nearbyintf(c) == 13.0f);
+  assert(__ESBMC_nearbyintf(d) == 0.0f && signbit(__ESBMC_nearbyintf(d)));
+
+  fesetround(FE_TOWARDZERO);
+  assert(__ESBMC_nearbyintf(a) == 2.0f && __ESBMC_nearbyintf(b) == -2.0f);
+  assert(__ESBMC_nearbyintf(c) == 12.0f);
+
+  // Already integral, or not finite
+  fesetround(FE_TONEAREST);
+  assert(__ESBMC_nearbyintf(big) == big);
+  assert(isinf(__ESBMC_nearbyintf(big * 0x1p100f)));
+  assert(isnan(__ESBMC_nearbyintf(big * 0x1p100f - big * 0x1p100f)));
+  return 0;
+}
@@ -0,0 +1,26 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int(), c = nondet_int();
+  int x = 0;
+
+  if(a > 0)
+    x += 1;
+  else
+    x -= 1;
+
+  if(b > 0)
+    x += 2;
+  else
+    x -= 2;
+
+  if(c > 0)
+    x += 4;
+
+  assert(x >= -3 && x <= 7);
+  assert(x != 0);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <assert.h>
+
+int nondet_int();
+
+int x, y;
+
+void f(int a, int b, int c)
+{
+  if(a) {
+    if(b)
+      return;
+    if(c) {
+      y = 2;
+      return;
+    }
+  }
+  x = 1;
+}
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int(), c = nondet_int();
+  x = 0;
+  y = 0;
+
+  f(a, b, c);
+
+  assert(x == !(a && (b || c)));
+  assert(y == (a && !b && c ? 2 : 0));
+  return 0;
+}
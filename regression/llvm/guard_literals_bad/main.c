@@ -0,0 +1,25 @@
+#include <assert.h>
+
+int nondet_int();
+
+int x;
+
+void f(int a, int b)
+{
+  if(a) {
+    if(b)
+      return;
+  }
+  x = 1;
+}
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int();
+  x = 0;
+
+  f(a, b);
+
+  assert(x == 1);
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  // Large enough for the flattener to treat as unbounded, which is where
+  // the lazy axioms apply
+  int a[4096], b[4096];
+  unsigned int i = nondet_uint(), j = nondet_uint();
+  __ESBMC_assume(i < 4096 && j < 4096);
+
+  // Only an ackerman lemma ties these two reads together
+  assert(i != j || b[i] == b[j]);
+
+  // Only a frame lemma keeps the first write when the second misses it
+  a[i] = 1;
+  a[j] = 2;
+  assert(a[j] == 2);
+  assert(i == j || a[i] == 1);
+  return 0;
+}
@@ -0,0 +1,17 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  int a[4096];
+  unsigned int i = nondet_uint(), j = nondet_uint();
+  __ESBMC_assume(i < 4096 && j < 4096);
+
+  // Holds whenever the writes miss each other, which the first model need
+  // not respect; fails for real only when they alias
+  a[i] = 1;
+  a[j] = 2;
+  assert(a[i] == 1);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <assert.h>
+#include <stdlib.h>
+
+int nondet_int();
+
+struct node {
+  int val;
+  struct node *next;
+};
+
+int a[4];
+int b;
+
+int main()
+{
+  int i = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 4);
+
+  int *p = &a[i];
+  int *q = nondet_int() ? p : &a[0];
+  assert(q != &b);
+  assert(q >= &a[0] && q < &a[4]);
+
+  struct node *n = malloc(sizeof(struct node));
+  __ESBMC_assume(n != NULL);
+  n->next = nondet_int() ? n : NULL;
+  n->val = 1;
+  if(n->next != NULL)
+    assert(n->next->val == 1);
+  return 0;
+}
@@ -0,0 +1,17 @@
+#include <assert.h>
+
+int nondet_int();
+
+int a[4];
+int b;
+
+int main()
+{
+  int i = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 4);
+
+  int *p = &a[i];
+  int *q = i == 2 ? &b : p;
+  assert(q != &b);
+  return 0;
+}
@@ -0,0 +1,16 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int();
+  __ESBMC_assume(a >= 0 && a < 100 && b >= 0 && b < 100);
+
+  int x = (a * b + a) / 3;
+  int y = (a * b + b) / 3;
+
+  assert(x == (a * b + a) / 3);
+  assert(x == y);
+  return 0;
+}
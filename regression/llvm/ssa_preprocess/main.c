@@ -0,0 +1,22 @@
+#include <assert.h>
+
+int nondet_int();
+unsigned char nondet_uchar();
+
+int main()
+{
+  int k = 3;
+  int a = nondet_int();
+  int b = a;
+  int c = b + k;
+  unsigned char u = nondet_uchar();
+  int w = u;
+  int unused = nondet_int() * 7;
+
+  assert(c - a == 3);
+  assert(w < 256);
+  assert(w >= 0);
+  if(unused == 14)
+    assert(c == b + 3);
+  return 0;
+}
@@ -0,0 +1,16 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int();
+  __ESBMC_assume(b > -100 && b < 100);
+
+  // a is an input used nowhere else, but a + b is checked for overflow:
+  // the sum can't be taken for an unconstrained value.
+  int x = a / 4 + b;
+  int y = a / 4 + b;
+  assert(x == y);
+  return 0;
+}
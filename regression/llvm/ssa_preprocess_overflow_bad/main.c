@@ -0,0 +1,16 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int();
+  int b = nondet_int();
+  __ESBMC_assume(b > 0);
+
+  // Overflows for large a; replacing a + b by a fresh value would hide it.
+  int x = a + b;
+  int y = a + b;
+  assert(x == y);
+  return 0;
+}
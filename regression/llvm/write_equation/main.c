@@ -0,0 +1,12 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int();
+  __ESBMC_assume(a > 0 && a < 10);
+  int x = a * 3;
+  assert(x != 15);
+  return 0;
+}
@@ -27,6 +27,16 @@ static const int     single_bits = sizeof (onedig_t) * CHAR_BIT;
 static const twodig_t base       = twodig_t (1) << single_bits;
 static const twodig_t single_max = base - 1;
 
+// Widest elementary type available, for doing arithmetic on operands
+// that fit into one directly rather than digit by digit.
+#if defined __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 wide_t;
+#else
+typedef ullong_t wide_t;
+#endif
+
+static const unsigned wide_digits = sizeof (wide_t) / sizeof (onedig_t);
+
 
 inline unsigned
 adjust_size (unsigned size)
@@ -269,12 +279,21 @@ digit_div (onedig_t *r, const onedig_t *y, unsigned yl, onedig_t *q, unsigned ql
 }
 
 // Newly allocate uninitialized space for specified number of digits.
+// Uses the inline digits where they suffice.
 inline void
 BigInt::allocate (unsigned digits)
 {
-  size = adjust_size (digits);
+  if(digits <= inline_digits)
+  {
+    size = inline_digits;
+    digit = inline_digit;
+  }
+  else
+  {
+    size = adjust_size(digits);
+    digit = new onedig_t[size];
+  }
   length = 0;
-  digit = new onedig_t[size];
 }
 
 // Used in assignment: When smaller than specified digits, allocate
@@ -284,10 +303,11 @@ BigInt::reallocate (unsigned digits)
 {
   if(digits > size)
   {
-    if(size != 0u)
+    unsigned old_length = length;
+    if(on_heap())
       delete[] digit;
-    size = adjust_size(digits);
-    digit = new onedig_t[size];
+    allocate(digits);
+    length = old_length;
   }
 }
 
@@ -298,14 +318,15 @@ BigInt::resize (unsigned digits)
   if(digits > size)
   {
     onedig_t *old_digit = digit;
-    unsigned old_size = size;
-    size = adjust_size(digits);
-    digit = new onedig_t[size];
+    bool old_heap = on_heap();
+    unsigned old_length = length;
+    allocate(digits);
+    length = old_length;
 
     if(old_digit != nullptr)
     {
       memcpy(digit, old_digit, length * sizeof(onedig_t));
-      if(old_size != 0u)
+      if(old_heap)
         delete[] old_digit;
     }
   }
@@ -327,6 +348,31 @@ BigInt::adjust()
   }
 }
 
+// Read digit string into a wide_t, which it must fit into.
+inline wide_t
+wide_get (onedig_t const *d, unsigned l)
+{
+  wide_t w = 0;
+  while(l != 0u)
+  {
+    w <<= single_bits;
+    w |= d[--l];
+  }
+  return w;
+}
+
+// Store a wide_t into string of onedig_t, of at least wide_digits.
+inline void
+wide_set (wide_t w, onedig_t *d, unsigned &l)
+{
+  l = 0;
+  while(w != 0u)
+  {
+    d[l++] = onedig_t(w);
+    w >>= single_bits;
+  }
+}
+
 // Store unsigned elementary integer type into string of onedig_t.
 inline void
 digit_set (ullong_t ul, onedig_t d[small], unsigned &l)
@@ -372,7 +418,7 @@ BigInt::assign (llong_t l)
 
 BigInt::~BigInt()
 {
-  if (size > 0)
+  if (on_heap())
     {
       memset (digit, 0, size * sizeof digit[0]); // Crypto-paranoia.
       delete[] digit;
@@ -387,73 +433,72 @@ BigInt::BigInt (onedig_t *dig, unsigned len, bool pos)
 {}
 
 BigInt::BigInt()
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size]),
+    digit (inline_digit),
     positive (true)
 {}
 
 BigInt::BigInt (signed long int n)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (llong_t (n));
 }
 
 BigInt::BigInt (unsigned long int n)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (ullong_t (n));
 }
 
 BigInt::BigInt (int n)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (llong_t (n));
 }
 
 BigInt::BigInt (unsigned u)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (ullong_t (u));
 }
 
 BigInt::BigInt (llong_t l)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (l);
 }
 
 BigInt::BigInt (ullong_t ul)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size])
+    digit (inline_digit)
 {
   assign (ul);
 }
 
 BigInt::BigInt (BigInt const &y)
-  : size (adjust_size (y.length)),
-    length (y.length),
-    digit (new onedig_t[size]),
-    positive (y.positive)
+  : positive (y.positive)
 {
+  allocate (y.length);
+  length = y.length;
   memcpy (digit, y.digit, length * sizeof (onedig_t));
 }
 
 BigInt::BigInt (char const *s, onedig_t b)
-  : size (adjust_size (small)),
+  : size (inline_digits),
     length (0),
-    digit (new onedig_t[size]),
+    digit (inline_digit),
     positive (true)
 {
   scan (s, b);
@@ -575,19 +620,35 @@ BigInt::as_string (char *p, unsigned l, onedig_t b) const
     p[--l] = '0';
     return p + l;
   }
-  // Make a temporary copy of the digits.
-  onedig_t *dig = (onedig_t *) alloca(len * sizeof(onedig_t));
-  memcpy(dig, digit, len * sizeof(onedig_t));
-  // Divide down by single, generating digits from right to left.
-  do
+  if(len <= small)
   {
-    if(l == 0)
-      return nullptr;
-    onedig_t r = digit_div(dig, len, b);
-    p[--l] = r < 10 ? r + '0' : 'A' + r - 10;
-    if(dig[len - 1] == 0)
-      --len;
-  } while(len != 0u);
+    // Fits into an ullong_t, which can be divided down directly.
+    ullong_t ul = to_ulong();
+    do
+    {
+      if(l == 0)
+        return nullptr;
+      onedig_t r = onedig_t(ul % b);
+      p[--l] = r < 10 ? r + '0' : 'A' + r - 10;
+      ul /= b;
+    } while(ul != 0u);
+  }
+  else
+  {
+    // Make a temporary copy of the digits.
+    onedig_t *dig = (onedig_t *) alloca(len * sizeof(onedig_t));
+    memcpy(dig, digit, len * sizeof(onedig_t));
+    // Divide down by single, generating digits from right to left.
+    do
+    {
+      if(l == 0)
+        return nullptr;
+      onedig_t r = digit_div(dig, len, b);
+      p[--l] = r < 10 ? r + '0' : 'A' + r - 10;
+      if(dig[len - 1] == 0)
+        --len;
+    } while(len != 0u);
+  }
   // Maybe attach sign.
   if(!positive)
   {
@@ -759,17 +820,11 @@ BigInt::compare (ullong_t b) const
   if(!positive)
     return -1;
 
-  onedig_t dig[small];
-  unsigned len;
-  digit_set(b, dig, len);
-
-  if(length < len)
-    return -1;
-
-  if(length > len)
+  if(length > small)
     return 1;
 
-  return digit_cmp(digit, dig, len);
+  ullong_t a = to_ulong();
+  return a < b ? -1 : a > b ? 1 : 0;
 }
 
 int
@@ -793,6 +848,27 @@ BigInt::compare (BigInt const &b) const
 void
 BigInt::add (onedig_t const *dig, unsigned len, bool pos)
 {
+  if(length < wide_digits && len < wide_digits)
+  {
+    // Both magnitudes and their sum fit into a wide_t.
+    wide_t a = wide_get(digit, length);
+    wide_t b = wide_get(dig, len);
+    if(positive == pos)
+      a += b;
+    else if(a >= b)
+      a -= b;
+    else
+    {
+      a = b - a;
+      positive = pos;
+    }
+    resize(wide_digits);
+    wide_set(a, digit, length);
+    if(length == 0)
+      positive = true;
+    return;
+  }
+
   // Make sure the result fits into this, even with carry.
   resize((length > len ? length : len) + 1);
 
@@ -843,6 +919,19 @@ BigInt::add (onedig_t const *dig, unsigned len, bool pos)
 void
 BigInt::mul (onedig_t const *dig, unsigned len, bool pos)
 {
+  if(length + len <= wide_digits)
+  {
+    // The product fits into a wide_t.
+    wide_t p = wide_get(digit, length) * wide_get(dig, len);
+    resize(wide_digits);
+    wide_set(p, digit, length);
+    if(length == 0)
+      positive = true;
+    else if(!pos)
+      positive = !positive;
+    return;
+  }
+
   if(len < 2)
   {
     // Handle small dig/len operand efficiently.
@@ -885,7 +974,7 @@ BigInt::mul (onedig_t const *dig, unsigned len, bool pos)
   else
   {
     // Get a new string of digits for the result.
-    unsigned old_size = size;
+    bool old_heap = on_heap();
     size = adjust_size(length + len);
     auto r = new onedig_t[size];
 
@@ -897,7 +986,7 @@ BigInt::mul (onedig_t const *dig, unsigned len, bool pos)
       digit_mul(dig, len, digit, length, r);
 
     // Replace digit string of this with result.
-    if(old_size != 0u)
+    if(old_heap)
       delete[] digit;
     digit = r;
     length += len;
@@ -1079,7 +1168,7 @@ BigInt::div (BigInt const &x, BigInt const &y, BigInt &q, BigInt &r)
   else if(y.length == 1)
   {
     // This digit_div() transforms the dividend into the quotient.
-    q = y;
+    q = x;
     r.digit[0] = digit_div(q.digit, q.length, y.digit[0]);
     r.length = r.digit[0] != 0u ? 1 : 0;
   }
@@ -1110,8 +1199,8 @@ BigInt::div (BigInt const &x, BigInt const &y, BigInt &q, BigInt &r)
       a[al++] = 0;
 
     // Prepare q for receiving the quotient.
+    q.resize(al - bl);
     q.length = al - bl;
-    q.resize(q.length);
 
     // Divide.
     digit_div(a, b, bl, q.digit, q.length);
@@ -1123,8 +1212,8 @@ BigInt::div (BigInt const &x, BigInt const &y, BigInt &q, BigInt &r)
       digit_div(a, al, scale);
     if((al != 0u) && a[al - 1] == 0)
       --al;
+    r.resize(al);
     r.length = al;
-    r.resize(r.length);
     memcpy(r.digit, a, al * sizeof(onedig_t));
   }
   q.adjust();
@@ -115,11 +115,19 @@ public:
   // by an elementary type.
   enum { small = sizeof (ullong_t) / sizeof (onedig_t) };
 
+  // Number of digits kept within the object itself. Values up to twice
+  // the width of an ullong_t never touch the heap.
+  enum { inline_digits = 2 * small };
+
 private:
   unsigned size;			// Length of digit vector.
   unsigned length;			// Used places in digit vector.
   onedig_t *digit;			// Least significant first.
   bool positive;			// Signed magnitude representation.
+  onedig_t inline_digit[inline_digits];	// Digits, when they fit.
+
+  // Whether digit was obtained by new[] and is to be delete[]d.
+  bool on_heap() const	{ return size != 0 && digit != inline_digit; }
 
   // Create or resize this.
   inline void allocate (unsigned digits);
@@ -11,6 +11,9 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <sys/types.h>
 
 #ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #else
 #include <windows.h>
@@ -20,18 +23,25 @@ Authors: Daniel Kroening, kroening@kroening.com
 #endif
 
 #include <ac_config.h>
+#include <algorithm>
+#include <cstdio>
 #include <esbmc/bmc.h>
 #include <esbmc/document_subgoals.h>
 #include <fstream>
 #include <goto-symex/build_goto_trace.h>
+#include <goto-symex/equation_serialization.h>
 #include <goto-symex/goto_trace.h>
 #include <goto-symex/reachability_tree.h>
 #include <goto-symex/slice.h>
+#include <goto-symex/ssa_cse.h>
+#include <goto-symex/ssa_preprocess.h>
 #include <goto-symex/xml_goto_trace.h>
 #include <langapi/language_util.h>
 #include <langapi/languages.h>
 #include <langapi/mode.h>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include <util/i2string.h>
 #include <util/irep2.h>
 #include <util/location.h>
@@ -52,6 +62,7 @@ bmct::bmct(const goto_functionst &funcs,
 {
   interleaving_number = 0;
   interleaving_failed = 0;
+  cube_traced = false;
 
   if(options.get_bool_option("smt-during-symex"))
   {
@@ -149,6 +160,12 @@ void bmct::error_trace(
   goto_tracet goto_trace;
   build_goto_trace(eq, smt_conv, goto_trace);
 
+  // The GraphML witness shows the same steps as the plain trace
+  if(ui == ui_message_handlert::GRAPHML || ui == ui_message_handlert::PLAIN)
+    goto_trace.fetch_values(is_shown_assignment);
+  else
+    goto_trace.fetch_all_values();
+
   switch (ui)
   {
     case ui_message_handlert::GRAPHML:
@@ -208,6 +225,13 @@ bmct::run_decision_procedure(
   str << "s";
   status(str.str());
 
+  std::ostringstream cache_str;
+  cache_str << "Conversion cache: " << smt_conv->smt_cache.hits << " hits, "
+            << smt_conv->smt_cache.misses << " misses; function applications: "
+            << smt_conv->func_app_cache.hits << " shared, "
+            << smt_conv->func_app_cache.misses << " made";
+  print(9, cache_str.str());
+
   if(options.get_bool_option("smt-formula-too")
      || options.get_bool_option("smt-formula-only"))
   {
@@ -220,7 +244,7 @@ bmct::run_decision_procedure(
   status(ss.str());
 
   fine_timet sat_start=current_time();
-  smt_convt::resultt dec_result = smt_conv->dec_solve();
+  smt_convt::resultt dec_result = smt_conv->dec_solve_refined();
   fine_timet sat_stop=current_time();
 
   // output runtime
@@ -382,7 +406,12 @@ void bmct::report_trace(
       break;
 
     case smt_convt::P_SATISFIABLE:
-      if(!bs && show_cex) {
+      if(cube_traced) {
+        // Built by the worker that found the cube satisfiable
+        std::cout << cube_trace;
+        cube_traced = false;
+        cube_trace.clear();
+      } else if(!bs && show_cex) {
         error_trace(runtime_solver, eq);
       } else if(!is && !fc) {
         error_trace(runtime_solver, eq);
@@ -534,6 +563,9 @@ smt_convt::resultt bmct::run_thread(boost::shared_ptr<symex_target_equationt> &e
 
   fine_timet symex_stop = current_time();
 
+  // Otherwise the equation's exprs stay pinned, and copied on every write
+  simplify_memo_clear();
+
   eq = boost::dynamic_pointer_cast<symex_target_equationt>(result->target);
 
   {
@@ -567,6 +599,44 @@ smt_convt::resultt bmct::run_thread(boost::shared_ptr<symex_target_equationt> &e
       status(str.str());
     }
 
+    if(options.get_bool_option("ssa-preprocess")
+       && !options.get_bool_option("smt-during-symex"))
+    {
+      fine_timet preprocess_start = current_time();
+      symex_preprocesst preprocess;
+      preprocess.preprocess(eq);
+      ignored += preprocess.ignored;
+      fine_timet preprocess_stop = current_time();
+
+      std::ostringstream str;
+      str << "Preprocessing time: ";
+      output_time(preprocess_stop - preprocess_start, str);
+      str << "s";
+      str << " (removed " << preprocess.ignored << " assignments, ";
+      str << preprocess.substituted << " equalities and ";
+      str << preprocess.propagated << " constants propagated, ";
+      str << preprocess.narrowed << " comparisons narrowed, ";
+      str << preprocess.unconstrained << " unconstrained terms)";
+      status(str.str());
+    }
+
+    if(options.get_bool_option("ssa-cse")
+       && !options.get_bool_option("smt-during-symex"))
+    {
+      fine_timet cse_start = current_time();
+      symex_cset cse;
+      cse.cse(eq);
+      fine_timet cse_stop = current_time();
+
+      std::ostringstream str;
+      str << "Subexpression sharing time: ";
+      output_time(cse_stop - cse_start, str);
+      str << "s";
+      str << " (" << cse.defined << " subterms defined, ";
+      str << cse.replaced << " occurrences replaced)";
+      status(str.str());
+    }
+
     if (options.get_bool_option("program-only") ||
         options.get_bool_option("program-too"))
       show_program(eq);
@@ -574,6 +644,27 @@ smt_convt::resultt bmct::run_thread(boost::shared_ptr<symex_target_equationt> &e
     if (options.get_bool_option("program-only"))
       return smt_convt::P_SMTLIB;
 
+    if(options.get_option("write-equation") != "")
+    {
+      fine_timet write_start = current_time();
+      std::string filename = options.get_option("write-equation");
+      std::ofstream out(filename.c_str(), std::ios::binary);
+      bool int_encoding = options.get_bool_option("int-encoding");
+      if(!out || write_symex_equation(out, context, *eq.get(), int_encoding))
+      {
+        error("Failed to write the equation to `" + filename + "'");
+        return smt_convt::P_ERROR;
+      }
+      fine_timet write_stop = current_time();
+
+      std::ostringstream str;
+      str << "Equation writing time: ";
+      output_time(write_stop - write_start, str);
+      str << "s";
+      status(str.str());
+      return smt_convt::P_SMTLIB;
+    }
+
     {
       std::ostringstream str;
       str << "Generated " << result->total_claims << " VCC(s), ";
@@ -607,17 +698,152 @@ smt_convt::resultt bmct::run_thread(boost::shared_ptr<symex_target_equationt> &e
       return smt_convt::P_UNSATISFIABLE;
     }
 
-    if (!options.get_bool_option("smt-during-symex")) {
-      runtime_solver =
-        boost::shared_ptr<smt_convt>(
-          create_solver_factory(
-            "",
-            options.get_bool_option("int-encoding"),
-            ns,
-            options));
+    return solve(eq);
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(std::bad_alloc&)
+  {
+    std::cout << "Out of memory" << std::endl;
+    return smt_convt::P_ERROR;
+  }
+}
+
+static void add_pointer_object(
+  const expr2tc &obj,
+  std::unordered_set<expr2tc, irep2_hash> &objects)
+{
+  // Down to the base the solver numbers when taking obj's address
+  if(is_index2t(obj))
+    add_pointer_object(to_index2t(obj).source_value, objects);
+  else if(is_member2t(obj))
+    add_pointer_object(to_member2t(obj).source_value, objects);
+  else if(is_typecast2t(obj))
+    add_pointer_object(to_typecast2t(obj).from, objects);
+  else if(is_if2t(obj))
+  {
+    add_pointer_object(to_if2t(obj).true_value, objects);
+    add_pointer_object(to_if2t(obj).false_value, objects);
+  }
+  else
+    objects.insert(obj);
+}
+
+static void collect_pointer_objects(
+  const expr2tc &expr,
+  std::unordered_set<const expr2t *> &seen,
+  std::unordered_set<expr2tc, irep2_hash> &objects)
+{
+  if(is_nil_expr(expr) || !seen.insert(expr.get()).second)
+    return;
+
+  if(is_address_of2t(expr))
+    add_pointer_object(to_address_of2t(expr).ptr_obj, objects);
+
+  expr->foreach_operand([&seen, &objects] (const expr2tc &e)
+    {
+      collect_pointer_objects(e, seen, objects);
     }
+  );
+}
+
+static unsigned int count_pointer_objects(
+  const symex_target_equationt &eq)
+{
+  // An upper bound on the objects the solver will number: everything whose
+  // address is taken, one more for each renumbering, and NULL and INVALID
+  std::unordered_set<const expr2t *> seen;
+  std::unordered_set<expr2tc, irep2_hash> objects;
+  unsigned int renumbered = 0;
+  for(const auto &step : eq.SSA_steps)
+  {
+    if(step.ignore)
+      continue;
+
+    if(step.is_renumber())
+      renumbered++;
+
+    collect_pointer_objects(step.guard, seen, objects);
+    collect_pointer_objects(step.cond, seen, objects);
+    for(const auto &arg : step.output_args)
+      collect_pointer_objects(arg, seen, objects);
+  }
+
+  return objects.size() + renumbered + 2;
+}
+
+smt_convt::resultt bmct::solve(boost::shared_ptr<symex_target_equationt> &eq)
+{
+  // Whatever slicing and preprocessing simplified won't come up again
+  simplify_memo_clear();
+
+  cube_traced = false;
+  cube_trace.clear();
+
+  if (!options.get_bool_option("smt-during-symex")) {
+    // The object number bits of packed pointers are sized to fit
+    if(options.get_bool_option("packed-pointers"))
+      options.set_option(
+        "pointer-objects",
+        static_cast<int>(count_pointer_objects(*eq)));
+
+    // Dropped until the cubes are done with: cube workers would otherwise
+    // inherit it, along with the pipes to an smtlib solver process
+    runtime_solver.reset();
+  }
+
+#ifndef _WIN32
+  if(options.get_option("cube-depth") != ""
+     && !options.get_bool_option("smt-during-symex")
+     && !options.get_bool_option("smt-formula-too")
+     && !options.get_bool_option("smt-formula-only"))
+  {
+    unsigned int depth =
+      strtoul(options.get_option("cube-depth").c_str(), nullptr, 10);
 
-    return run_decision_procedure(runtime_solver, eq);
+    // Beyond this, there are far more cubes than could ever be solved
+    if(depth > 16)
+      depth = 16;
+
+    std::vector<expr2tc> splits = pick_split_guards(eq, depth);
+    if(splits.empty())
+      status("No path guards to split on, solving the whole formula");
+    else
+      return solve_cubes(eq, splits);
+  }
+#endif
+
+  if (!options.get_bool_option("smt-during-symex"))
+    runtime_solver =
+      boost::shared_ptr<smt_convt>(
+        create_solver_factory(
+          "",
+          options.get_bool_option("int-encoding"),
+          ns,
+          options));
+
+  return run_decision_procedure(runtime_solver, eq);
+}
+
+smt_convt::resultt bmct::solve_from(
+  boost::shared_ptr<symex_target_equationt> &eq)
+{
+  smt_convt::resultt res;
+
+  try
+  {
+    res = solve(eq);
   }
 
   catch(std::string &error_str)
@@ -637,4 +863,360 @@ smt_convt::resultt bmct::run_thread(boost::shared_ptr<symex_target_equationt> &e
     std::cout << "Out of memory" << std::endl;
     return smt_convt::P_ERROR;
   }
+
+  if(res == smt_convt::P_SATISFIABLE || res == smt_convt::P_UNSATISFIABLE)
+    report_trace(res, eq);
+
+  report_result(res);
+  return res;
 }
+
+static void collect_guard_symbols(
+  const expr2tc &expr,
+  std::unordered_set<const expr2t *> &seen,
+  std::vector<expr2tc> &guards)
+{
+  if(is_nil_expr(expr) || !seen.insert(expr.get()).second)
+    return;
+
+  if(is_symbol2t(expr))
+  {
+    if(to_symbol2t(expr).thename == "goto_symex::guard")
+      guards.push_back(expr);
+    return;
+  }
+
+  expr->foreach_operand([&seen, &guards] (const expr2tc &e)
+    {
+      collect_guard_symbols(e, seen, guards);
+    }
+  );
+}
+
+std::vector<expr2tc> bmct::pick_split_guards(
+  boost::shared_ptr<symex_target_equationt> &eq,
+  unsigned int depth)
+{
+  // Steps in one block share their guard, so count the steps per guard
+  // first and look into each guard once.
+  std::vector<const expr2t *> order;
+  std::unordered_map<const expr2t *, std::pair<expr2tc, unsigned int> > steps;
+  for(const auto &step : eq->SSA_steps)
+  {
+    if(step.ignore || is_nil_expr(step.guard))
+      continue;
+
+    auto it = steps.find(step.guard.get());
+    if(it == steps.end())
+    {
+      order.push_back(step.guard.get());
+      steps[step.guard.get()] = std::make_pair(step.guard, 1);
+    }
+    else
+      it->second.second++;
+  }
+
+  std::vector<expr2tc> splits;
+  std::unordered_map<expr2tc, unsigned int, irep2_hash> guarded;
+  for(const expr2t *g : order)
+  {
+    std::unordered_set<const expr2t *> seen;
+    std::vector<expr2tc> guards;
+    collect_guard_symbols(steps[g].first, seen, guards);
+
+    for(const expr2tc &sym : guards)
+    {
+      auto it = guarded.find(sym);
+      if(it == guarded.end())
+      {
+        splits.push_back(sym);
+        guarded[sym] = steps[g].second;
+      }
+      else
+        it->second += steps[g].second;
+    }
+  }
+
+  // Stable, so outer branches stay ahead of inner ones that guard as much
+  std::stable_sort(splits.begin(), splits.end(),
+    [&guarded] (const expr2tc &a, const expr2tc &b)
+    {
+      return guarded[a] > guarded[b];
+    }
+  );
+
+  if(splits.size() > depth)
+    splits.resize(depth);
+  return splits;
+}
+
+#ifndef _WIN32
+static void assume_cube(
+  boost::shared_ptr<symex_target_equationt> &eq,
+  const std::vector<expr2tc> &splits,
+  unsigned int cube)
+{
+  expr2tc cond;
+  for(unsigned int i = 0; i < splits.size(); i++)
+  {
+    expr2tc lit = splits[i];
+    if(!(cube & (1u << i)))
+      lit = not2tc(lit);
+
+    cond = is_nil_expr(cond) ? lit : and2tc(cond, lit);
+  }
+
+  // Ahead of every assertion, so all of them are checked under the cube
+  symex_target_equationt::SSA_stept step;
+  step.source = eq->SSA_steps.front().source;
+  step.type = goto_trace_stept::ASSUME;
+  step.guard = gen_true_expr();
+  step.cond = cond;
+  eq->SSA_steps.push_front(step);
+}
+
+static bool write_all(int fd, const char *buf, size_t len)
+{
+  while(len)
+  {
+    ssize_t n = write(fd, buf, len);
+    if(n == -1 && errno == EINTR)
+      continue;
+    if(n <= 0)
+      return true;
+    buf += n;
+    len -= n;
+  }
+
+  return false;
+}
+
+smt_convt::resultt bmct::solve_cubes(
+  boost::shared_ptr<symex_target_equationt> &eq,
+  const std::vector<expr2tc> &splits)
+{
+  unsigned int cubes = 1u << splits.size();
+  long workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if(options.get_option("cube-workers") != "")
+    workers = strtol(options.get_option("cube-workers").c_str(), nullptr, 10);
+  if(workers < 1)
+    workers = 1;
+
+  {
+    std::ostringstream str;
+    str << "Splitting on " << splits.size() << " guards into " << cubes
+        << " cubes, " << std::min<long>(workers, cubes) << " solved at once";
+    status(str.str());
+  }
+
+  fine_timet cubes_start = current_time();
+
+  // Workers inherit the output buffers
+  std::cout.flush();
+  std::cerr.flush();
+
+  // Each worker writes its own witness, so as not to clobber the others; the
+  // one of the satisfiable cube is then renamed to the requested file
+  std::string witness = options.get_option("witness-output");
+  bool graphml = ui == ui_message_handlert::GRAPHML && witness != "";
+  auto cube_witness = [&witness] (unsigned int cube)
+  {
+    return witness + ".cube" + i2string(cube);
+  };
+
+  // The cube and the read end of the result pipe of each worker
+  std::map<pid_t, std::pair<unsigned int, int> > running;
+  unsigned int next = 0, solved = 0;
+  int sat = -1;
+  bool failed = false;
+
+  // Once there's an answer, or none can be had, nothing else is worth waiting
+  // for; the workers are still reaped below. Each worker leads a process
+  // group of its own, so that a solver process it forked goes with it
+  auto stop_workers = [&running] ()
+  {
+    for(const auto &r : running)
+      kill(-r.first, SIGKILL);
+  };
+
+  while(!running.empty()
+        || (next < cubes && sat == -1 && !failed))
+  {
+    if(next < cubes && sat == -1 && !failed && (long) running.size() < workers)
+    {
+      int result_pipe[2];
+      if(pipe(result_pipe))
+      {
+        error("Pipe creation failed, giving up on the remaining cubes");
+        failed = true;
+        stop_workers();
+        continue;
+      }
+
+      pid_t pid = fork();
+      if(pid == -1)
+      {
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        error("Fork failed, giving up on the remaining cubes");
+        failed = true;
+        stop_workers();
+        continue;
+      }
+
+      // Both sides set the group, so it exists whichever runs first
+      if(!pid)
+      {
+        setpgid(0, 0);
+        close(result_pipe[0]);
+
+        smt_convt::resultt res = smt_convt::P_ERROR;
+        std::ostringstream trace;
+        try
+        {
+          assume_cube(eq, splits, next);
+          boost::shared_ptr<smt_convt> smt_conv(
+            create_solver_factory(
+              "",
+              options.get_bool_option("int-encoding"),
+              ns,
+              options));
+          do_cbmc(smt_conv, eq);
+          res = smt_conv->dec_solve_refined();
+
+          // The counterexample comes from this model, sent back along with
+          // the answer, rather than from solving the cube over again
+          if(res == smt_convt::P_SATISFIABLE)
+          {
+            if(graphml)
+              options.set_option("witness-output", cube_witness(next));
+
+            runtime_solver = smt_conv;
+            std::streambuf *out = std::cout.rdbuf(trace.rdbuf());
+            report_trace(res, eq);
+            std::cout.flush();
+            std::cout.rdbuf(out);
+          }
+        }
+
+        catch(...)
+        {
+          res = smt_convt::P_ERROR;
+        }
+
+        std::string text = trace.str();
+        if(write_all(result_pipe[1], (const char *) &res, sizeof(res))
+           || write_all(result_pipe[1], text.data(), text.size()))
+          _exit(1);
+        _exit(0);
+      }
+
+      setpgid(pid, pid);
+      close(result_pipe[1]);
+      running[pid] = std::make_pair(next++, result_pipe[0]);
+      continue;
+    }
+
+    // A trace may not fit in the pipe, so answers are read before their
+    // worker is reaped; a stopped worker just closes its pipe
+    std::vector<pollfd> fds;
+    for(const auto &r : running)
+      fds.push_back(pollfd{r.second.second, POLLIN, 0});
+
+    if(poll(fds.data(), fds.size(), -1) == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+
+    auto it = running.begin();
+    for(const pollfd &fd : fds)
+    {
+      if(fd.revents)
+        break;
+      ++it;
+    }
+
+    if(it == running.end())
+      continue;
+
+    smt_convt::resultt res = smt_convt::P_ERROR;
+    std::string trace;
+    int fd = it->second.second;
+    if(read(fd, &res, sizeof(res)) != sizeof(res))
+      res = smt_convt::P_ERROR;
+    else
+    {
+      char buf[4096];
+      ssize_t n;
+      while((n = read(fd, buf, sizeof(buf))) != 0)
+      {
+        if(n > 0)
+          trace.append(buf, n);
+        else if(errno != EINTR)
+          break;
+      }
+    }
+    close(fd);
+
+    while(waitpid(it->first, nullptr, 0) == -1 && errno == EINTR)
+      ;
+
+    unsigned int cube = it->second.first;
+    running.erase(it);
+
+    // Anything after the first answer comes from workers being stopped
+    if(sat != -1 || failed)
+      continue;
+
+    if(res == smt_convt::P_UNSATISFIABLE)
+    {
+      solved++;
+      continue;
+    }
+
+    if(res == smt_convt::P_SATISFIABLE)
+    {
+      sat = cube;
+      cube_traced = true;
+      cube_trace = trace;
+      if(graphml)
+        std::rename(cube_witness(cube).c_str(), witness.c_str());
+    }
+    else
+    {
+      std::ostringstream str;
+      str << "Worker solving cube " << cube << " failed";
+      error(str.str());
+      failed = true;
+    }
+
+    stop_workers();
+  }
+
+  fine_timet cubes_stop = current_time();
+
+  std::ostringstream str;
+  str << "\nRuntime decision procedure: ";
+  output_time(cubes_stop - cubes_start, str);
+  str << "s (" << solved << " of " << cubes << " cubes unsatisfiable)";
+  status(str.str());
+
+  // Whatever the stopped workers left behind
+  if(graphml)
+    for(unsigned int cube = 0; cube < next; cube++)
+      std::remove(cube_witness(cube).c_str());
+
+  if(failed)
+    return smt_convt::P_ERROR;
+
+  if(sat == -1)
+    return smt_convt::P_UNSATISFIABLE;
+
+  std::ostringstream sat_str;
+  sat_str << "Cube " << sat << " is satisfiable";
+  status(sat_str.str());
+  return smt_convt::P_SATISFIABLE;
+}
+#endif
@@ -37,6 +37,10 @@ public:
 
   virtual smt_convt::resultt start_bmc();
   virtual smt_convt::resultt run(boost::shared_ptr<symex_target_equationt> &eq);
+
+  /** Solve an equation that was read back with read_symex_equation, and
+   *  report on it as run does. */
+  smt_convt::resultt solve_from(boost::shared_ptr<symex_target_equationt> &eq);
   ~bmct() override = default;
 
   void set_ui(language_uit::uit _ui) { ui=_ui; }
@@ -45,6 +49,10 @@ protected:
   const contextt &context;
   namespacet ns;
   boost::shared_ptr<smt_convt> runtime_solver;
+  // The counterexample of the satisfiable cube, as its worker printed it;
+  // report_trace prints this instead of building one when cube_traced is set
+  bool cube_traced;
+  std::string cube_trace;
   std::shared_ptr<reachability_treet> symex;
 
   // use gui format
@@ -81,6 +89,23 @@ protected:
   virtual void report_result(smt_convt::resultt &res);
 
   smt_convt::resultt run_thread(boost::shared_ptr<symex_target_equationt> &eq);
+
+  // Encode and solve a complete equation, in cubes if asked to
+  smt_convt::resultt solve(boost::shared_ptr<symex_target_equationt> &eq);
+
+  /** Pick up to depth path guard symbols to split the equation on: those
+   *  that guard the most steps, i.e. the outermost branches, first. */
+  std::vector<expr2tc> pick_split_guards(
+    boost::shared_ptr<symex_target_equationt> &eq,
+    unsigned int depth);
+
+  /** Solve eq as one cube per assignment of the split guards, each in a
+   *  worker process with a solver of its own, until one is satisfiable or
+   *  all are not. The worker of the satisfying cube builds its trace from
+   *  its own model and sends it back, to be printed by report_trace. */
+  smt_convt::resultt solve_cubes(
+    boost::shared_ptr<symex_target_equationt> &eq,
+    const std::vector<expr2tc> &splits);
 };
 
 #endif
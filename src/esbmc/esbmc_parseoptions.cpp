@@ -45,6 +45,7 @@ extern "C" {
 #include <goto-programs/remove_unreachable.h>
 #include <goto-programs/set_claims.h>
 #include <goto-programs/show_claims.h>
+#include <goto-symex/equation_serialization.h>
 #include <util/irep.h>
 #include <langapi/languages.h>
 #include <langapi/mode.h>
@@ -317,6 +318,9 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
   if(cmdline.isset("keep-unused"))
     options.set_option("keep-unused", true);
 
+  if(cmdline.isset("hash-cons"))
+    irep_hash_consing = true;
+
   config.options = options;
 }
 
@@ -376,6 +380,9 @@ int esbmc_parseoptionst::doit()
   optionst opts;
   get_command_line_options(opts);
 
+  if(cmdline.isset("solve-from"))
+    return doit_solve_from(opts);
+
   if(get_goto_program(opts, goto_functions))
     return 6;
 
@@ -395,7 +402,56 @@ int esbmc_parseoptionst::doit()
   // do actual BMC
   bmct bmc(goto_functions, opts, context, ui_message_handler);
   set_verbosity_msg(bmc);
-  return do_bmc(bmc);
+  int res = do_bmc(bmc);
+
+  // Writing the equation out is the whole job when it's asked for: that
+  // succeeded, so let a following --solve-from run
+  if(opts.get_option("write-equation") != "" && res == smt_convt::P_SMTLIB)
+    return 0;
+
+  return res;
+}
+
+int esbmc_parseoptionst::doit_solve_from(optionst &opts)
+{
+  std::string filename = cmdline.getval("solve-from");
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  if(!in)
+  {
+    error("failed to open `" + filename + "'");
+    return 6;
+  }
+
+  // The equation refers to the instructions it came from, which aren't
+  // loaded: it brings along what it needs of them in a program of its own
+  goto_programt program;
+  const namespacet ns(context);
+  migrate_namespace_lookup = new namespacet(context);
+
+  fine_timet read_start = current_time();
+  boost::shared_ptr<symex_target_equationt> eq(
+    new symex_target_equationt(ns));
+  if(read_symex_equation(in, context, program, *eq.get(),
+                         opts.get_bool_option("int-encoding"),
+                         ui_message_handler))
+    return 6;
+  fine_timet read_stop = current_time();
+
+  std::ostringstream str;
+  str << "Equation reading time: ";
+  output_time(read_stop - read_start, str);
+  str << "s (" << eq->SSA_steps.size() << " assignments)";
+  status(str.str());
+
+  bmct bmc(goto_functions, opts, context, ui_message_handler);
+  set_verbosity_msg(bmc);
+  bmc.set_ui(get_ui());
+
+  smt_convt::resultt res = bmc.solve_from(eq);
+  if(res == smt_convt::P_ERROR)
+    abort();
+
+  return res;
 }
 
 int esbmc_parseoptionst::doit_k_induction_parallel()
@@ -1660,6 +1716,8 @@ void esbmc_parseoptionst::help()
     " --smt-formula-only           only show SMT formula (not supported by all solvers)\n"
     " --smt-formula-too            show SMT formula (not supported by all solvers) and verify\n"
     " --show-smt-model             show SMT model (not supported by all solvers), if the formula is SAT\n"
+    " --write-equation filename    write the sliced equation to a binary file, to solve with --solve-from\n"
+    " --solve-from filename        solve an equation written by --write-equation\n"
 
     "\nTrace options\n"
     " --quiet                      do not print unwinding information during symbolic execution\n"
@@ -1718,6 +1776,9 @@ void esbmc_parseoptionst::help()
     " --partial-loops              permit paths with partial loops\n"
     " --unroll-loops               unwind all loops by the value defined by the --unwind option\n"
     " --no-slice                   do not remove unused equations\n"
+    " --ssa-preprocess             simplify the equation at word level before encoding it\n"
+    " --ssa-cse                    define subterms repeated across the equation once\n"
+    " --guard-literals             name each path guard with a fresh symbol when it changes\n"
     " --extended-try-analysis      check all the try block, even when an exception is thrown\n"
 
     "\nIncremental BMC\n"
@@ -1742,6 +1803,10 @@ void esbmc_parseoptionst::help()
     " --output <filename>          output VCCs in SMT lib format to given file\n"
     " --fixedbv                    encode floating-point as fixed bitvectors (default)\n"
     " --floatbv                    encode floating-point using the SMT floating-point theory\n"
+    " --packed-pointers            encode each pointer as one bitvector of object and offset\n"
+    "                              (with --smt-during-symex, the object is pointer-width)\n"
+    " --cube-depth nr              split on nr path guards, solving each cube in parallel\n"
+    " --cube-workers nr            number of cubes solved at once (default is one per core)\n"
 
     "\nIncremental SMT solving\n"
     " --smt-during-symex           enable incremental SMT solving (experimental)\n"
@@ -1793,6 +1858,7 @@ void esbmc_parseoptionst::help()
     " --timeout                    configure time limit, integer followed by {s,m,h}\n"
     " --memstats                   print memory usage statistics\n"
     " --no-simplify                do not simplify any expression\n"
+    " --hash-cons                  share structurally equal expressions\n"
     " --enable-core-dump           do not disable core dump output\n"
     "\n";
 }
@@ -51,6 +51,7 @@ protected:
   int doit_falsification();
   int doit_incremental();
   int doit_termination();
+  int doit_solve_from(optionst &opts);
 
   int do_base_case(
     optionst &opts,
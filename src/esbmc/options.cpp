@@ -27,6 +27,8 @@ const struct opt_templ esbmc_options[] = {
   { 0, "smt-formula-only", switc, "" },
   { 0, "smt-formula-too", switc, "" },
   { 0, "show-smt-model", switc, "" },
+  { 0, "write-equation", string, "" },
+  { 0, "solve-from", string, "" },
 
   // Trace
   { 0, "quiet", switc, "" },
@@ -78,6 +80,9 @@ const struct opt_templ esbmc_options[] = {
   { 0, "unroll-loops", switc, "" },
   { 0, "no-slice", switc, "" },
   { 0, "slice-assumes", switc, "" },
+  { 0, "ssa-preprocess", switc, "" },
+  { 0, "ssa-cse", switc, "" },
+  { 0, "guard-literals", switc, "" },
   { 0, "extended-try-analysis", switc, "" },
   { 0, "skip-bmc", switc, "" },
 
@@ -100,6 +105,8 @@ const struct opt_templ esbmc_options[] = {
   { 0, "output", string, "" },
   { 0, "floatbv", switc, "" },
   { 0, "fixedbv", switc, "" },
+  { 0, "cube-depth", number, "" },
+  { 0, "cube-workers", number, "" },
 
   // Incremental SMT
   { 0, "smt-during-symex", switc, "" },
@@ -150,6 +157,7 @@ const struct opt_templ esbmc_options[] = {
   { 0, "timeout", string, "" },
   { 0, "enable-core-dump", switc, "" },
   { 0, "no-simplify", switc, "" },
+  { 0, "hash-cons", switc, "" },
 
   // DEBUG options
 
@@ -167,6 +175,15 @@ const struct opt_templ esbmc_options[] = {
   { 0, "tuple-sym-flattener", switc, "" },
   { 0, "array-flattener", switc, "" },
 
+  // Add the flattener's array axioms on demand, as models break them
+  { 0, "lazy-arrays", switc, "" },
+
+  // Lower floating-point to bitvectors instead of using the solver's theory
+  { 0, "fp2bv", switc, "" },
+
+  // Encode pointers as one bitvector each rather than as tuples
+  { 0, "packed-pointers", switc, "" },
+
   // Abort if the program contains a recursion
   { 0, "abort-on-recursion", switc, "" },
 
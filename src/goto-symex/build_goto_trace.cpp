@@ -37,6 +37,60 @@ expr2tc build_rhs(boost::shared_ptr<smt_convt> &smt_conv, const expr2tc &rhs)
   return new_rhs;
 }
 
+static void fetch_trace_values(
+  boost::shared_ptr<smt_convt> &smt_conv,
+  goto_tracet &goto_trace,
+  const goto_tracet::step_filtert &filter)
+{
+  std::vector<expr2tc> values;
+  std::vector<goto_trace_stept *> pending;
+  for(auto &step : goto_trace.steps)
+  {
+    if(!step.value_pending)
+      continue;
+
+    // Every printer shows the output, whatever its filter
+    if(step.type == goto_trace_stept::OUTPUT)
+    {
+      for(const auto &arg : step.output_args)
+        if(!is_constant_expr(arg))
+          values.push_back(arg);
+      pending.push_back(&step);
+      continue;
+    }
+
+    if(!filter(step))
+      continue;
+
+    // Only the indexes of the lhs are fetched, see build_lhs
+    expr2tc lhs = step.original_lhs;
+    while(!is_nil_expr(lhs) && is_index2t(lhs))
+    {
+      values.push_back(to_index2t(lhs).index);
+      lhs = to_index2t(lhs).source_value;
+    }
+    values.push_back(step.rhs);
+    pending.push_back(&step);
+  }
+
+  if(!values.empty())
+    smt_conv->prefetch(values);
+  for(auto step : pending)
+  {
+    step->value_pending = false;
+    if(step->type == goto_trace_stept::OUTPUT)
+    {
+      for(auto &arg : step->output_args)
+        if(!is_constant_expr(arg))
+          arg = smt_conv->get(arg);
+      continue;
+    }
+
+    step->lhs = build_lhs(smt_conv, step->original_lhs);
+    step->value = build_rhs(smt_conv, step->rhs);
+  }
+}
+
 void build_goto_trace(
   const boost::shared_ptr<symex_target_equationt>& target,
   boost::shared_ptr<smt_convt> &smt_conv,
@@ -44,7 +98,18 @@ void build_goto_trace(
 {
   unsigned step_nr = 0;
 
-  for(auto SSA_step : target->SSA_steps)
+  // Guards and assertion results are needed for every step: ask for them in
+  // one batch rather than a query each.
+  std::vector<smt_astt> bools;
+  for(const auto & SSA_step : target->SSA_steps)
+  {
+    bools.push_back(SSA_step.guard_ast);
+    if(SSA_step.is_assert() || SSA_step.is_assume())
+      bools.push_back(SSA_step.cond_ast);
+  }
+  smt_conv->prefetch_values(bools);
+
+  for(const auto & SSA_step : target->SSA_steps)
   {
     tvt result = smt_conv->l_get(SSA_step.guard_ast);
     if(!result.is_true())
@@ -67,26 +132,31 @@ void build_goto_trace(
 
     goto_trace_step.stack_trace = SSA_step.stack_trace;
 
+    // Values are fetched once a consumer of the trace says which it shows
     if(SSA_step.is_assignment())
     {
-      goto_trace_step.lhs = build_lhs(smt_conv, SSA_step.original_lhs);
-      goto_trace_step.value = build_rhs(smt_conv, SSA_step.rhs);
+      goto_trace_step.rhs = SSA_step.rhs;
+      goto_trace_step.value_pending = true;
     }
 
     if(SSA_step.is_output())
     {
       for(const auto & arg : SSA_step.converted_output_args)
-      {
-        if (is_constant_expr(arg))
-          goto_trace_step.output_args.push_back(arg);
-        else
-          goto_trace_step.output_args.push_back(smt_conv->get(arg));
-      }
+        goto_trace_step.output_args.push_back(arg);
+      goto_trace_step.value_pending = true;
     }
 
     if(SSA_step.is_assert() || SSA_step.is_assume())
       goto_trace_step.guard = !smt_conv->l_get(SSA_step.cond_ast).is_false();
   }
+
+  boost::shared_ptr<smt_convt> model = smt_conv;
+  goto_trace.value_fetcher =
+    [model] (goto_tracet &trace, const goto_tracet::step_filtert &filter)
+    {
+      boost::shared_ptr<smt_convt> conv = model;
+      fetch_trace_values(conv, trace, filter);
+    };
 }
 
 void build_successful_goto_trace(
@@ -0,0 +1,470 @@
+/*******************************************************************\
+
+Module: Symex equation to binary conversions
+
+\*******************************************************************/
+
+#include <goto-symex/equation_serialization.h>
+#include <util/config.h>
+#include <util/i2string.h>
+#include <util/message_stream.h>
+#include <util/migrate.h>
+#include <util/symbol_serialization.h>
+
+#define EQUATION_BINARY_VERSION 2
+
+// Operands are written by reference, and stand in for them in the rest of
+// their expression as symbols of this name, with the operand index as level1
+// number so that migrate_expr parses them back.
+static const char operand_name[] = "symex::operand";
+
+void equation_serializationt::write_type(
+  const type2tc &type,
+  std::ostream &out)
+{
+  auto it = types_on_write.find(type);
+  if(it != types_on_write.end())
+  {
+    write_long(out, it->second);
+    return;
+  }
+
+  unsigned int id = types_on_write.size();
+  types_on_write[type] = id;
+  write_long(out, id);
+  irepconverter.reference_convert(migrate_type_back(type), out);
+}
+
+void equation_serializationt::write_expr(
+  const expr2tc &expr,
+  std::ostream &out)
+{
+  if(is_nil_expr(expr))
+  {
+    write_long(out, 0);
+    return;
+  }
+
+  auto it = exprs_on_write.find(expr);
+  if(it != exprs_on_write.end())
+  {
+    write_long(out, it->second);
+    return;
+  }
+
+  unsigned int id = exprs_on_write.size() + 1;
+  exprs_on_write[expr] = id;
+  write_long(out, id);
+
+  if(is_symbol2t(expr))
+  {
+    // Written out in full: migrating renamed symbols back folds their levels
+    // into the name
+    const symbol2t &sym = to_symbol2t(expr);
+    out.put('S');
+    write_type(sym.type, out);
+    irepconverter.write_string_ref(out, sym.thename);
+    write_long(out, sym.rlevel);
+    write_long(out, sym.level1_num);
+    write_long(out, sym.level2_num);
+    write_long(out, sym.thread_num);
+    write_long(out, sym.node_num);
+    return;
+  }
+
+  // Everything else is written as the irept of the node alone, with its
+  // operands written before it and standing in for them
+  out.put('E');
+  unsigned int num_ops = expr->get_num_sub_exprs();
+  write_long(out, num_ops);
+
+  expr2tc node = expr;
+  for(unsigned int idx = 0; idx < num_ops; idx++)
+  {
+    const expr2tc *op = expr->get_sub_expr(idx);
+    write_expr(*op, out);
+    if(!is_nil_expr(*op))
+      *node.get()->get_sub_expr_nc(idx) =
+        symbol2tc((*op)->type, operand_name, symbol2t::level1, idx, 0, 0, 0);
+  }
+
+  irepconverter.reference_convert(migrate_expr_back(node), out);
+}
+
+void equation_serializationt::write_source(
+  const symex_targett::sourcet &source,
+  std::ostream &out)
+{
+  write_long(out, source.thread_nr);
+
+  if(!source.is_set)
+  {
+    write_long(out, 0);
+    return;
+  }
+
+  auto it = pcs_on_write.find(&*source.pc);
+  if(it != pcs_on_write.end())
+  {
+    write_long(out, it->second);
+    return;
+  }
+
+  unsigned int id = pcs_on_write.size() + 1;
+  pcs_on_write[&*source.pc] = id;
+  write_long(out, id);
+  write_long(out, source.pc->type);
+  irepconverter.reference_convert(source.pc->location, out);
+  irepconverter.write_string_ref(out, source.pc->function);
+  write_expr(source.pc->guard, out);
+}
+
+void equation_serializationt::convert(
+  const symex_target_equationt &eq,
+  std::ostream &out)
+{
+  unsigned int count = 0;
+  for(const auto &step : eq.SSA_steps)
+    if(!step.ignore)
+      count++;
+
+  write_long(out, count);
+
+  for(const auto &step : eq.SSA_steps)
+  {
+    if(step.ignore)
+      continue;
+
+    write_long(out, step.type);
+    write_long(out, step.assignment_type);
+    write_source(step.source, out);
+    write_expr(step.guard, out);
+    write_expr(step.lhs, out);
+    write_expr(step.rhs, out);
+    write_expr(step.original_lhs, out);
+    write_expr(step.cond, out);
+    write_string(out, step.comment);
+    write_string(out, step.format_string);
+
+    write_long(out, step.output_args.size());
+    for(const auto &arg : step.output_args)
+      write_expr(arg, out);
+  }
+}
+
+// Everything read is checked for as it's read: ids index the tables below,
+// and counts size loops, so neither can be trusted from a damaged file.
+static void check_read(std::istream &in)
+{
+  if(!in.good())
+    throw "malformed equation binary";
+}
+
+static void check_new_id(unsigned int id, size_t next)
+{
+  // Ids are handed out in the order things are first written
+  if(id != next)
+    throw "malformed equation binary";
+}
+
+type2tc equation_serializationt::read_type(std::istream &in)
+{
+  unsigned int id = irep_serializationt::read_long(in);
+  check_read(in);
+  if(id < types_on_read.size())
+    return types_on_read[id];
+
+  check_new_id(id, types_on_read.size());
+
+  irept irep;
+  irepconverter.reference_convert(in, irep);
+  check_read(in);
+
+  type2tc type;
+  migrate_type(static_cast<const typet &>(irep), type);
+
+  types_on_read.push_back(type);
+  return type;
+}
+
+static void resolve_operands(expr2tc &expr, const std::vector<expr2tc> &ops)
+{
+  if(is_nil_expr(expr))
+    return;
+
+  if(is_symbol2t(expr) && to_symbol2t(expr).thename == operand_name)
+  {
+    unsigned int idx = to_symbol2t(expr).level1_num;
+    if(idx >= ops.size())
+      throw "malformed equation binary";
+    expr = ops[idx];
+    return;
+  }
+
+  expr->Foreach_operand([&ops] (expr2tc &e)
+    {
+      resolve_operands(e, ops);
+    }
+  );
+}
+
+expr2tc equation_serializationt::read_expr(std::istream &in)
+{
+  unsigned int id = irep_serializationt::read_long(in);
+  check_read(in);
+  if(id == 0)
+    return expr2tc();
+
+  if(id < exprs_on_read.size())
+  {
+    // Still nil if it's one of its own operands
+    if(is_nil_expr(exprs_on_read[id]))
+      throw "malformed equation binary";
+    return exprs_on_read[id];
+  }
+
+  // Numbered from one, before their operands are; the slot is held until
+  // the expression is complete
+  check_new_id(id, std::max<size_t>(exprs_on_read.size(), 1));
+  exprs_on_read.resize(id + 1);
+
+  expr2tc expr;
+  int tag = in.get();
+  check_read(in);
+  if(tag == 'S')
+  {
+    type2tc type = read_type(in);
+    irep_idt thename = irepconverter.read_string_ref(in);
+    unsigned int rlevel = irep_serializationt::read_long(in);
+    unsigned int level1_num = irep_serializationt::read_long(in);
+    unsigned int level2_num = irep_serializationt::read_long(in);
+    unsigned int thread_num = irep_serializationt::read_long(in);
+    unsigned int node_num = irep_serializationt::read_long(in);
+    check_read(in);
+    expr = symbol2tc(type, thename, symbol2t::renaming_level(rlevel),
+                     level1_num, level2_num, thread_num, node_num);
+  }
+  else if(tag == 'E')
+  {
+    unsigned int num_ops = irep_serializationt::read_long(in);
+    check_read(in);
+    std::vector<expr2tc> ops;
+    for(unsigned int idx = 0; idx < num_ops; idx++)
+      ops.push_back(read_expr(in));
+
+    irept irep;
+    irepconverter.reference_convert(in, irep);
+    check_read(in);
+    migrate_expr(static_cast<const exprt &>(irep), expr);
+    resolve_operands(expr, ops);
+  }
+  else
+    throw "malformed equation binary";
+
+  exprs_on_read[id] = expr;
+  return expr;
+}
+
+symex_targett::sourcet equation_serializationt::read_source(
+  std::istream &in,
+  goto_programt &program)
+{
+  symex_targett::sourcet source;
+  source.thread_nr = irep_serializationt::read_long(in);
+
+  unsigned int id = irep_serializationt::read_long(in);
+  check_read(in);
+  if(id == 0)
+    return source;
+
+  if(id >= pcs_on_read.size())
+  {
+    // Numbered from one, as expressions are
+    check_new_id(id, std::max<size_t>(pcs_on_read.size(), 1));
+
+    unsigned int type = irep_serializationt::read_long(in);
+    irept location;
+    irepconverter.reference_convert(in, location);
+    irep_idt function = irepconverter.read_string_ref(in);
+    check_read(in);
+
+    goto_programt::targett pc =
+      program.add_instruction(goto_program_instruction_typet(type));
+    pc->location = static_cast<const locationt &>(location);
+    pc->function = function;
+    pc->guard = read_expr(in);
+
+    pcs_on_read.resize(id + 1);
+    pcs_on_read[id] = pc;
+  }
+
+  source.pc = pcs_on_read[id];
+  source.prog = &program;
+  source.is_set = true;
+  return source;
+}
+
+void equation_serializationt::convert(
+  std::istream &in,
+  goto_programt &program,
+  symex_target_equationt &eq)
+{
+  unsigned int count = irep_serializationt::read_long(in);
+  check_read(in);
+  for(unsigned int i = 0; i < count; i++)
+  {
+    eq.SSA_steps.emplace_back();
+    symex_target_equationt::SSA_stept &step = eq.SSA_steps.back();
+
+    step.type = goto_trace_stept::typet(irep_serializationt::read_long(in));
+    step.assignment_type =
+      symex_targett::assignment_typet(irep_serializationt::read_long(in));
+    check_read(in);
+    step.source = read_source(in, program);
+    step.guard = read_expr(in);
+    step.lhs = read_expr(in);
+    step.rhs = read_expr(in);
+    step.original_lhs = read_expr(in);
+    step.cond = read_expr(in);
+    step.comment = irepconverter.read_string(in).as_string();
+    step.format_string = irepconverter.read_string(in).as_string();
+
+    unsigned int num_args = irep_serializationt::read_long(in);
+    check_read(in);
+    for(unsigned int j = 0; j < num_args; j++)
+      step.output_args.push_back(read_expr(in));
+  }
+}
+
+// Types in the equation carry their own widths, but the solver takes the
+// pointer and word sizes, the float encoding and whether to use integers from
+// the configuration, so those have to be the same as when it was written.
+struct machine_settingt
+{
+  const char *what;
+  unsigned int value;
+};
+
+static std::vector<machine_settingt> machine_settings(bool int_encoding)
+{
+  return {
+    { "pointer width", config.ansi_c.pointer_width },
+    { "word size", config.ansi_c.word_size },
+    { "int width", config.ansi_c.int_width },
+    { "long width", config.ansi_c.long_int_width },
+    { "endianness", (unsigned int) config.ansi_c.endianess },
+    { "fixed-point floats", config.ansi_c.use_fixed_for_float },
+    { "integer encoding", int_encoding }
+  };
+}
+
+bool write_symex_equation(
+  std::ostream &out,
+  const contextt &context,
+  const symex_target_equationt &eq,
+  bool int_encoding)
+{
+  // header
+  out << "ESE";
+  write_long(out, EQUATION_BINARY_VERSION);
+
+  for(const auto &setting : machine_settings(int_encoding))
+    write_long(out, setting.value);
+
+  irep_serializationt::ireps_containert irepc;
+  symbol_serializationt symbolconverter(irepc);
+  equation_serializationt eqconverter(irepc);
+
+  write_long(out, context.size());
+
+  context.foreach_operand_in_order(
+    [&symbolconverter, &out] (const symbolt& s)
+    {
+      symbolconverter.convert(s, out);
+    }
+  );
+
+  eqconverter.convert(eq, out);
+  return !out.good();
+}
+
+bool read_symex_equation(
+  std::istream &in,
+  contextt &context,
+  goto_programt &program,
+  symex_target_equationt &eq,
+  bool int_encoding,
+  message_handlert &message_handler)
+{
+  message_streamt message_stream(message_handler);
+
+  char hdr[3];
+  hdr[0] = in.get();
+  hdr[1] = in.get();
+  hdr[2] = in.get();
+  if(hdr[0] != 'E' || hdr[1] != 'S' || hdr[2] != 'E')
+  {
+    message_stream.error("not an equation binary");
+    return true;
+  }
+
+  if(irep_serializationt::read_long(in) != EQUATION_BINARY_VERSION)
+  {
+    message_stream.error(
+      "the equation binary was written by a different version");
+    return true;
+  }
+
+  for(const auto &setting : machine_settings(int_encoding))
+  {
+    unsigned int written = irep_serializationt::read_long(in);
+    if(!in.good())
+    {
+      message_stream.error("malformed equation binary");
+      return true;
+    }
+
+    if(written != setting.value)
+    {
+      message_stream.error(
+        std::string("the equation binary was written with ") + setting.what +
+        " " + i2string(written) + ", not " + i2string(setting.value) +
+        ": solve it with the --16/--32/--64, --floatbv/--fixedbv and "
+        "--int-encoding options it was written with");
+      return true;
+    }
+  }
+
+  irep_serializationt::ireps_containert irepc;
+  symbol_serializationt symbolconverter(irepc);
+  equation_serializationt eqconverter(irepc);
+
+  unsigned int count = irep_serializationt::read_long(in);
+  for(unsigned int i = 0; i < count; i++)
+  {
+    irept t;
+    symbolconverter.convert(in, t);
+    if(!in.good())
+    {
+      message_stream.error("malformed equation binary");
+      return true;
+    }
+
+    symbolt symbol;
+    symbol.from_irep(t);
+    context.add(symbol);
+  }
+
+  try
+  {
+    eqconverter.convert(in, program, eq);
+  }
+
+  catch(const char *error_str)
+  {
+    message_stream.error(error_str);
+    return true;
+  }
+
+  return false;
+}
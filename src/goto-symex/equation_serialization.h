@@ -0,0 +1,82 @@
+/*******************************************************************\
+
+Module: Symex equation to binary conversions
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_EQUATION_SERIALIZATION_H
+#define CPROVER_GOTO_SYMEX_EQUATION_SERIALIZATION_H
+
+#include <goto-symex/symex_target_equation.h>
+#include <unordered_map>
+#include <util/context.h>
+#include <util/irep_serialization.h>
+#include <util/message.h>
+#include <vector>
+
+/** Writes the steps of an equation that aren't ignored, and reads them back,
+ *  possibly in another process. Each distinct term is written once, and
+ *  referred to by number after that, so the DAG of the equation stays a DAG
+ *  on disk. Types, locations and strings go through irep_serializationt,
+ *  which shares them in the same way.
+ *
+ *  The instructions steps come from don't exist where the equation is read.
+ *  What traces need of them (type, location, guard and function) is written
+ *  along with the steps, and read back into a program of its own. */
+class equation_serializationt
+{
+public:
+  equation_serializationt(irep_serializationt::ireps_containert &ic)
+    : irepconverter(ic)
+  {
+  }
+
+  void convert(const symex_target_equationt &eq, std::ostream &out);
+  void convert(
+    std::istream &in,
+    goto_programt &program,
+    symex_target_equationt &eq);
+
+protected:
+  irep_serializationt irepconverter;
+
+  std::unordered_map<expr2tc, unsigned int, irep2_hash> exprs_on_write;
+  std::unordered_map<type2tc, unsigned int, type2_hash> types_on_write;
+  std::unordered_map<const goto_programt::instructiont *, unsigned int>
+    pcs_on_write;
+
+  std::vector<expr2tc> exprs_on_read;
+  std::vector<type2tc> types_on_read;
+  std::vector<goto_programt::const_targett> pcs_on_read;
+
+  void write_expr(const expr2tc &expr, std::ostream &out);
+  void write_type(const type2tc &type, std::ostream &out);
+  void write_source(const symex_targett::sourcet &source, std::ostream &out);
+
+  expr2tc read_expr(std::istream &in);
+  type2tc read_type(std::istream &in);
+  symex_targett::sourcet read_source(std::istream &in, goto_programt &program);
+};
+
+/** Write the machine configuration, the symbol table and the equation;
+ *  returns true on failure.
+ *  @param int_encoding Whether the equation is for integer/real encoding. */
+bool write_symex_equation(
+  std::ostream &out,
+  const contextt &context,
+  const symex_target_equationt &eq,
+  bool int_encoding);
+
+/** Read what write_symex_equation wrote, adding the symbols to context and
+ *  the instructions the steps refer to to program; returns true on
+ *  failure. Fails if the equation was written for another machine
+ *  configuration or encoding than the one in use. */
+bool read_symex_equation(
+  std::istream &in,
+  contextt &context,
+  goto_programt &program,
+  symex_target_equationt &eq,
+  bool int_encoding,
+  message_handlert &message_handler);
+
+#endif
@@ -236,6 +236,16 @@ protected:
    */
   void phi_function(const statet::goto_statet &goto_state);
 
+  /**
+   *  Name a guard with a fresh guard symbol.
+   *  With --guard-literals, a guard that has become a conjunction is
+   *  assigned to a new guard symbol, and refers to that symbol from then on.
+   *  Extending the guard further then conjoins to the symbol rather than to
+   *  the whole chain, so that guards grow linearly with branch depth.
+   *  @param guard Guard to be named.
+   */
+  void make_guard_literal(guardt &guard);
+
   /**
    *  Test whether unwinding bound has been exceeded.
    *  This looks up a look number, checks the limit on unwindings against the
@@ -777,6 +787,9 @@ protected:
   /** Flag as to whether we're doing a k-induction inductive step.
    *  Corresponds to the option --inductive-step */
   bool inductive_step;
+  /** Flag as to whether guards are named by a fresh symbol whenever they
+   *  change. Corresponds to the option --guard-literals */
+  bool guard_literals;
   /** Names of functions that we've complained about missing bodies of. */
   static hash_set_cont<irep_idt, irep_id_hash> body_warnings;
   /** Set of dereference state records; this field is used as a mailbox between
@@ -27,6 +27,24 @@
 
 extern std::string verification_file;
 
+void goto_tracet::fetch_values(const step_filtert &filter)
+{
+  if(value_fetcher)
+    value_fetcher(*this, filter);
+}
+
+void goto_tracet::fetch_all_values()
+{
+  fetch_values([](const goto_trace_stept &) { return true; });
+}
+
+bool is_shown_assignment(const goto_trace_stept &step)
+{
+  // original_lhs rather than lhs, which isn't built for pending steps
+  return step.pc->is_assign() || step.pc->is_return()
+         || (step.pc->is_other() && is_nil_expr(step.original_lhs));
+}
+
 void goto_tracet::output(const class namespacet &ns, std::ostream &out) const
 {
   for(const auto & step : steps)
@@ -283,8 +301,7 @@ void violation_graphml_goto_trace(
         break;
 
       case goto_trace_stept::ASSIGNMENT:
-        if(step.pc->is_assign() || step.pc->is_return()
-           || (step.pc->is_other() && is_nil_expr(step.lhs)))
+        if(is_shown_assignment(step))
         {
 
           std::string assignment = get_formated_assignment(ns, step);
@@ -390,8 +407,7 @@ void show_goto_trace(
         break;
 
       case goto_trace_stept::ASSIGNMENT:
-        if(step.pc->is_assign() || step.pc->is_return()
-            || (step.pc->is_other() && is_nil_expr(step.lhs)))
+        if(is_shown_assignment(step))
         {
           if(prev_step_nr != step.step_nr || first_step)
           {
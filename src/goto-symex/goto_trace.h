@@ -12,6 +12,7 @@ Date: July 2005
 #define CPROVER_GOTO_SYMEX_GOTO_TRACE_H
 
 #include <fstream>
+#include <functional>
 #include <goto-programs/goto_program.h>
 #include <goto-symex/symex_target.h>
 #include <iostream>
@@ -58,6 +59,10 @@ public:
   // original expression
   expr2tc original_lhs;
 
+  // lhs and value, or the output_args, are still to be fetched from the
+  // model, see goto_tracet::fetch_values; rhs is what to fetch the value of
+  bool value_pending;
+
   // for OUTPUT
   std::string format_string;
   std::list<expr2tc> output_args;
@@ -69,7 +74,8 @@ public:
   goto_trace_stept():
     step_nr(0),
     thread_nr(0),
-    guard(false)
+    guard(false),
+    value_pending(false)
   {
   }
 };
@@ -82,10 +88,23 @@ public:
   stepst steps;
   std::string mode;
 
+  typedef std::function<bool (const goto_trace_stept &)> step_filtert;
+  typedef std::function<void (goto_tracet &, const step_filtert &)>
+    value_fetchert;
+
+  // When built from a model, a trace has no values yet. Consumers fetch the
+  // values of the steps they show, along with the output, in one batch.
+  void fetch_values(const step_filtert &filter);
+  void fetch_all_values();
+
+  // Set by build_goto_trace; keeps the model the values come from alive
+  value_fetchert value_fetcher;
+
   void clear()
   {
     mode.clear();
     steps.clear();
+    value_fetcher = nullptr;
   }
 
   void output(
@@ -93,6 +112,9 @@ public:
     std::ostream &out) const;
 };
 
+// Whether show_goto_trace and the witnesses print an assignment step
+bool is_shown_assignment(const goto_trace_stept &step);
+
 void show_goto_trace_gui(
   std::ostream &out,
   const namespacet &ns,
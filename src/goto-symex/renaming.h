@@ -87,7 +87,8 @@ namespace renaming {
       }
     };
 
-    typedef hash_map_cont<name_record, unsigned, name_rec_hash> current_namest;
+    typedef flat_hash_map_cont<name_record, unsigned, name_rec_hash>
+      current_namest;
     current_namest current_names;
     unsigned int thread_id;
 
@@ -274,7 +275,8 @@ namespace renaming {
 
     friend void build_goto_symex_classes();
     // Repeat of the above ignored friend directive.
-    typedef hash_map_cont<name_record, valuet, name_rec_hash> current_namest;
+    typedef flat_hash_map_cont<name_record, valuet, name_rec_hash>
+      current_namest;
 
     current_namest current_names;
     typedef std::map<const expr2tc, crypto_hash> current_state_hashest;
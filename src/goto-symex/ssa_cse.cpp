@@ -0,0 +1,202 @@
+/*******************************************************************\
+
+Module: Common subexpression elimination for symex equations
+
+\*******************************************************************/
+
+#include <goto-symex/ssa_cse.h>
+#include <goto-symex/ssa_preprocess.h>
+#include <util/i2string.h>
+#include <util/irep2_utils.h>
+
+symex_cset::symex_cset()
+  : defined(0),
+    replaced(0),
+    steps(nullptr)
+{
+}
+
+bool symex_cset::is_opaque(const expr2tc &expr)
+{
+  return symex_preprocesst::is_opaque(expr);
+}
+
+bool symex_cset::is_candidate(const expr2tc &expr)
+{
+  if(is_symbol2t(expr) || is_constant_expr(expr))
+    return false;
+
+  if(is_code_type(expr) || is_empty_type(expr))
+    return false;
+
+  bool deep = false;
+  expr->foreach_operand([&deep] (const expr2tc &e)
+    {
+      deep = deep ||
+             (!is_nil_expr(e) && !is_symbol2t(e) && !is_constant_expr(e));
+    }
+  );
+  return deep;
+}
+
+template <typename F>
+void symex_cset::foreach_expr(SSA_stept &step, F &&f)
+{
+  f(step.guard);
+
+  if(step.is_assignment())
+    f(step.rhs);
+  else if(step.is_assume() || step.is_assert())
+    f(step.cond);
+  else if(step.is_output())
+    for(auto &arg : step.output_args)
+      f(arg);
+}
+
+void symex_cset::count(
+  const expr2tc &expr,
+  seent &seen,
+  countst &counts,
+  bool prune)
+{
+  if(is_nil_expr(expr))
+    return;
+
+  // Every occurrence counts, even of a node that's shared, as all equal
+  // ones are under hash consing; only the descent into it happens once
+  bool candidate = is_candidate(expr);
+  if(candidate)
+    ++counts[expr];
+
+  if(!seen.insert(expr.get()).second)
+    return;
+
+  if(is_opaque(expr))
+    return;
+
+  if(prune && candidate)
+  {
+    countst::const_iterator it = repeated.find(expr);
+    if(it != repeated.end() && it->second > 1 &&
+       !descended.insert(expr).second)
+      return;
+  }
+
+  expr->foreach_operand([this, &seen, &counts, prune] (const expr2tc &e)
+    {
+      count(e, seen, counts, prune);
+    }
+  );
+}
+
+expr2tc symex_cset::replace(const expr2tc &expr, bool top)
+{
+  if(is_nil_expr(expr))
+    return expr;
+
+  if(!top)
+  {
+    auto it = memo.find(expr.get());
+    if(it != memo.end())
+      return it->second.second;
+  }
+
+  expr2tc res = expr;
+  if(!top && is_candidate(expr) && repeated.count(expr))
+  {
+    auto it = names.find(expr);
+    if(it != names.end())
+      res = it->second;
+    else
+    {
+      // Define the shape with its own repeated subterms named, before the
+      // step that first uses it.
+      SSA_stept step;
+      step.source = insert_point->source;
+      step.type = goto_trace_stept::ASSIGNMENT;
+      step.assignment_type = symex_targett::HIDDEN;
+      step.guard = gen_true_expr();
+      step.lhs = symbol2tc(expr->type, "symex::cse::" + i2string(defined++));
+      step.original_lhs = step.lhs;
+      step.rhs = replace(expr, true);
+      step.cond = equality2tc(step.lhs, step.rhs);
+      steps->insert(insert_point, step);
+
+      names[expr] = step.lhs;
+      res = step.lhs;
+    }
+
+    ++replaced;
+  }
+  else if(!is_opaque(expr))
+  {
+    for(unsigned int idx = 0; idx < expr->get_num_sub_exprs(); idx++)
+    {
+      const expr2tc *op = expr->get_sub_expr(idx);
+      expr2tc new_op = replace(*op, false);
+      if(new_op.get() != op->get())
+        *res.get()->get_sub_expr_nc(idx) = new_op;
+    }
+  }
+
+  if(!top)
+    memo[expr.get()] = std::make_pair(expr, res);
+  return res;
+}
+
+void symex_cset::cse(boost::shared_ptr<symex_target_equationt> &eq)
+{
+  steps = &eq->SSA_steps;
+
+  // Count every node first, then again without looking into the copies of
+  // repeated shapes: what's only repeated because its parent is doesn't
+  // need a name of its own.
+  seent seen;
+  for(auto &step : eq->SSA_steps)
+    if(!step.ignore)
+      foreach_expr(step, [this, &seen](const expr2tc &e)
+        {
+          count(e, seen, repeated, false);
+        }
+      );
+
+  countst counts;
+  seen.clear();
+  for(auto &step : eq->SSA_steps)
+    if(!step.ignore)
+      foreach_expr(step, [this, &seen, &counts](const expr2tc &e)
+        {
+          count(e, seen, counts, true);
+        }
+      );
+
+  repeated.clear();
+  descended.clear();
+  for(const auto &c : counts)
+    if(c.second > 1)
+      repeated.insert(c);
+
+  if(repeated.empty())
+    return;
+
+  for(SSA_stepst::iterator it = eq->SSA_steps.begin();
+      it != eq->SSA_steps.end();
+      it++)
+  {
+    if(it->ignore)
+      continue;
+
+    insert_point = it;
+    expr2tc old_rhs = it->rhs;
+    foreach_expr(*it, [this](expr2tc &e)
+      {
+        e = replace(e, false);
+      }
+    );
+
+    if(it->is_assignment() && it->rhs.get() != old_rhs.get())
+      it->cond = equality2tc(it->lhs, it->rhs);
+  }
+
+  memo.clear();
+}
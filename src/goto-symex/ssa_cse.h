@@ -0,0 +1,65 @@
+/*******************************************************************\
+
+Module: Common subexpression elimination for symex equations
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_SSA_CSE_H
+#define CPROVER_GOTO_SYMEX_SSA_CSE_H
+
+#include <goto-symex/symex_target_equation.h>
+#include <unordered_map>
+#include <unordered_set>
+
+/** Finds subterms that occur in more than one place of an equation, as one
+ *  shared node or as structurally equal ones, and defines each once as a fresh
+ *  hidden symbol that replaces all of its occurrences. Conversion then
+ *  hashes, compares and converts the subterm once, and solvers and formula
+ *  dumps see it once.
+ *
+ *  Terms are only named when they have some depth: naming a single operator
+ *  applied to leaves costs as much as it saves. */
+class symex_cset
+{
+public:
+  symex_cset();
+  void cse(boost::shared_ptr<symex_target_equationt> &eq);
+
+  /** Number of fresh definitions, and of the occurrences they replaced. */
+  unsigned int defined;
+  BigInt replaced;
+
+protected:
+  typedef symex_target_equationt::SSA_stept SSA_stept;
+  typedef symex_target_equationt::SSA_stepst SSA_stepst;
+  typedef std::unordered_map<expr2tc, unsigned int, irep2_hash> countst;
+  typedef std::unordered_set<const expr2t *> seent;
+
+  /** Whether the conversion of expr looks at the shape of its operands, so
+   *  they can't be swapped for symbols. */
+  static bool is_opaque(const expr2tc &expr);
+  static bool is_candidate(const expr2tc &expr);
+
+  template <typename F>
+  void foreach_expr(SSA_stept &step, F &&f);
+
+  /** Count the occurrences of each shape under expr, looking into each
+   *  node once. With prune set, only the first node of a shape that's
+   *  already repeated is looked into, as the others will be replaced by its
+   *  definition. */
+  void count(const expr2tc &expr, seent &seen, countst &counts, bool prune);
+  expr2tc replace(const expr2tc &expr, bool top);
+
+  countst repeated;
+  std::unordered_set<expr2tc, irep2_hash> descended;
+  /** Fresh symbol of each named shape, and the rewritten node of each
+   *  original node. */
+  std::unordered_map<expr2tc, expr2tc, irep2_hash> names;
+  std::unordered_map<const expr2t *, std::pair<expr2tc, expr2tc> > memo;
+
+  /** Where definitions made while rewriting a step go: before it. */
+  SSA_stepst *steps;
+  SSA_stepst::iterator insert_point;
+};
+
+#endif
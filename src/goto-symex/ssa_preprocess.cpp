@@ -0,0 +1,498 @@
+/*******************************************************************\
+
+Module: Word-level preprocessing of symex equations
+
+\*******************************************************************/
+
+#include <goto-symex/ssa_preprocess.h>
+#include <util/arith_tools.h>
+#include <util/i2string.h>
+#include <util/irep2_utils.h>
+#include <util/prefix.h>
+
+symex_preprocesst::symex_preprocesst()
+  : substituted(0),
+    propagated(0),
+    narrowed(0),
+    unconstrained(0),
+    ignored(0),
+    fresh_count(0)
+{
+}
+
+bool symex_preprocesst::is_opaque(const expr2tc &expr)
+{
+  switch(expr->expr_id)
+  {
+  case expr2t::address_of_id:
+  case expr2t::overflow_id:
+  case expr2t::overflow_cast_id:
+  case expr2t::overflow_neg_id:
+  case expr2t::pointer_offset_id:
+  case expr2t::pointer_object_id:
+  case expr2t::valid_object_id:
+  case expr2t::deallocated_obj_id:
+  case expr2t::dynamic_size_id:
+  case expr2t::invalid_pointer_id:
+    return true;
+  default:
+    return false;
+  }
+}
+
+expr2tc symex_preprocesst::rewrite(
+  const expr2tc &expr,
+  memot &memo,
+  const postt &post)
+{
+  if(is_nil_expr(expr))
+    return expr;
+
+  memot::const_iterator it = memo.find(expr.get());
+  if(it != memo.end())
+    return it->second.second;
+
+  expr2tc res = expr;
+  if(!is_opaque(expr))
+  {
+    for(unsigned int idx = 0; idx < expr->get_num_sub_exprs(); idx++)
+    {
+      const expr2tc *op = expr->get_sub_expr(idx);
+      if(is_nil_expr(*op))
+        continue;
+
+      expr2tc new_op = rewrite(*op, memo, post);
+      if(new_op.get() != op->get())
+        // The first of these detaches res from expr.
+        *res.get()->get_sub_expr_nc(idx) = new_op;
+    }
+  }
+
+  res = post(expr, res);
+  memo[expr.get()] = std::make_pair(expr, res);
+  return res;
+}
+
+void symex_preprocesst::rewrite_step(
+  SSA_stept &step,
+  memot &memo,
+  const postt &post)
+{
+  auto rewrite_simplified = [this, &memo, &post](expr2tc &e) -> bool
+    {
+      expr2tc tmp = rewrite(e, memo, post);
+      if(tmp.get() == e.get())
+        return false;
+
+      simplify(tmp);
+      e = tmp;
+      return true;
+    };
+
+  rewrite_simplified(step.guard);
+
+  switch(step.type)
+  {
+  case goto_trace_stept::ASSIGNMENT:
+    // The lhs is a definition, not a use.
+    if(rewrite_simplified(step.rhs))
+      step.cond = equality2tc(step.lhs, step.rhs);
+    break;
+
+  case goto_trace_stept::ASSUME:
+  case goto_trace_stept::ASSERT:
+    rewrite_simplified(step.cond);
+    if(is_true(step.cond))
+    {
+      step.ignore = true;
+      ++ignored;
+    }
+    break;
+
+  case goto_trace_stept::OUTPUT:
+    for(auto &arg : step.output_args)
+      rewrite_simplified(arg);
+    break;
+
+  default:
+    // Renumbering assigns a fresh object to its lhs; leave it alone.
+    break;
+  }
+}
+
+unsigned int symex_preprocesst::number(const expr2tc &sym)
+{
+  std::pair<hash_map_cont<std::string, unsigned int, string_hash>::iterator,
+            bool> res =
+    numbers.insert(std::make_pair(to_symbol2t(sym).get_symbol_name(),
+                                  symbols.size()));
+  if(res.second)
+  {
+    symbols.push_back(sym);
+    representative.push_back(sym);
+    classes.check_index(res.first->second);
+  }
+
+  return res.first->second;
+}
+
+void symex_preprocesst::collect_equalities(SSA_stepst &steps)
+{
+  // A renumbered symbol doesn't have a single value; don't merge it.
+  hash_set_cont<std::string, string_hash> renumbered;
+  for(const auto &step : steps)
+    if(!step.ignore && step.is_renumber())
+      renumbered.insert(to_symbol2t(step.lhs).get_symbol_name());
+
+  for(const auto &step : steps)
+  {
+    if(step.ignore || !step.is_assignment() || !is_symbol2t(step.rhs))
+      continue;
+
+    if(step.lhs->type != step.rhs->type)
+      continue;
+
+    if(renumbered.count(to_symbol2t(step.lhs).get_symbol_name()) ||
+       renumbered.count(to_symbol2t(step.rhs).get_symbol_name()))
+      continue;
+
+    unsigned int l = number(step.lhs), r = number(step.rhs);
+    if(classes.same_set(l, r))
+      continue;
+
+    // Steps are in definition order, so the rhs' class already has the
+    // representative that the merged class should keep.
+    expr2tc rep = representative[classes.find(r)];
+    classes.make_union(l, r);
+    representative[classes.find(l)] = rep;
+    ++substituted;
+  }
+}
+
+expr2tc symex_preprocesst::substitute(const expr2tc &expr)
+{
+  if(!is_symbol2t(expr))
+    return expr;
+
+  expr2tc res = expr;
+  hash_map_cont<std::string, unsigned int, string_hash>::const_iterator it =
+    numbers.find(to_symbol2t(expr).get_symbol_name());
+  if(it != numbers.end())
+    res = representative[classes.find(it->second)];
+
+  hash_map_cont<std::string, expr2tc, string_hash>::const_iterator c_it =
+    constants.find(to_symbol2t(res).get_symbol_name());
+  if(c_it != constants.end())
+    return c_it->second;
+
+  return res;
+}
+
+/** Whether expr widens an integer without changing its value, and in a way
+ *  that keeps the order of values. Sign extending into an unsigned type moves
+ *  negative values above the positive ones, so it isn't counted. */
+static bool is_extension(const expr2tc &expr)
+{
+  if(!is_typecast2t(expr) || !is_bv_type(expr))
+    return false;
+
+  const expr2tc &from = to_typecast2t(expr).from;
+  if(!is_bv_type(from) || from->type->get_width() >= expr->type->get_width())
+    return false;
+
+  return !(is_signedbv_type(from) && is_unsignedbv_type(expr));
+}
+
+/** Whether value is representable in the integer type t. */
+static bool fits(const BigInt &value, const type2tc &t)
+{
+  unsigned int width = t->get_width();
+  if(is_unsignedbv_type(t))
+    return value >= 0 && value < power(2, width);
+
+  BigInt half = power(2, width - 1);
+  return value >= -half && value < half;
+}
+
+expr2tc symex_preprocesst::narrow(const expr2tc &expr)
+{
+  bool is_eq = is_equality2t(expr) || is_notequal2t(expr);
+  if(!is_eq && !is_lessthan2t(expr) && !is_lessthanequal2t(expr) &&
+     !is_greaterthan2t(expr) && !is_greaterthanequal2t(expr))
+    return expr;
+
+  const expr2tc &side_1 = *expr->get_sub_expr(0);
+  const expr2tc &side_2 = *expr->get_sub_expr(1);
+  expr2tc new_1, new_2;
+
+  if(is_extension(side_1) && is_extension(side_2))
+  {
+    const expr2tc &from_1 = to_typecast2t(side_1).from;
+    const expr2tc &from_2 = to_typecast2t(side_2).from;
+    if(from_1->type != from_2->type)
+      return expr;
+
+    new_1 = from_1;
+    new_2 = from_2;
+  }
+  else if(is_eq && (is_extension(side_1) || is_extension(side_2)))
+  {
+    const expr2tc &cast = is_extension(side_1) ? side_1 : side_2;
+    const expr2tc &other = is_extension(side_1) ? side_2 : side_1;
+    if(!is_constant_int2t(other))
+      return expr;
+
+    const expr2tc &from = to_typecast2t(cast).from;
+    const BigInt &value = to_constant_int2t(other).value;
+    if(!fits(value, from->type))
+    {
+      // The extended operand can't take this value at all.
+      ++narrowed;
+      return is_equality2t(expr) ? gen_false_expr() : gen_true_expr();
+    }
+
+    new_1 = from;
+    new_2 = constant_int2tc(from->type, value);
+  }
+  else
+    return expr;
+
+  expr2tc res = expr;
+  *res.get()->get_sub_expr_nc(0) = new_1;
+  *res.get()->get_sub_expr_nc(1) = new_2;
+  ++narrowed;
+  return res;
+}
+
+void symex_preprocesst::propagate(SSA_stepst &steps)
+{
+  memot memo;
+  postt post = [this](const expr2tc &, const expr2tc &e) -> expr2tc
+    {
+      expr2tc res = substitute(e);
+      if(res.get() != e.get())
+        return res;
+
+      return narrow(e);
+    };
+
+  for(auto &step : steps)
+  {
+    if(step.ignore)
+      continue;
+
+    rewrite_step(step, memo, post);
+
+    if(!step.is_assignment() || !is_constant_number(step.rhs))
+      continue;
+
+    std::string name = to_symbol2t(step.lhs).get_symbol_name();
+    if(constants.insert(std::make_pair(name, step.rhs)).second)
+      ++propagated;
+  }
+}
+
+void symex_preprocesst::get_symbols(
+  const expr2tc &expr,
+  std::unordered_set<const expr2t *> &seen,
+  std::function<void (const symbol2t &)> fn)
+{
+  if(is_nil_expr(expr) || !seen.insert(expr.get()).second)
+    return;
+
+  if(is_symbol2t(expr))
+  {
+    fn(to_symbol2t(expr));
+    return;
+  }
+
+  expr->foreach_operand([this, &seen, &fn] (const expr2tc &e)
+    {
+      get_symbols(e, seen, fn);
+    }
+  );
+}
+
+bool symex_preprocesst::is_unconstrained(const expr2tc &expr) const
+{
+  if(is_nil_expr(expr) || !is_symbol2t(expr) || !is_bv_type(expr))
+    return false;
+
+  // Inputs are the symbols nothing defines: nondets, and level two names
+  // that are read before any assignment.
+  const symbol2t &sym = to_symbol2t(expr);
+  if(!has_prefix(sym.thename.as_string(), "nondet$") &&
+     sym.rlevel != symbol2t::level2 && sym.rlevel != symbol2t::level2_global)
+    return false;
+
+  std::string name = sym.get_symbol_name();
+  if(defined.count(name))
+    return false;
+
+  hash_map_cont<std::string, unsigned int, string_hash>::const_iterator it =
+    uses.find(name);
+  return it != uses.end() && it->second == 1;
+}
+
+expr2tc symex_preprocesst::make_unconstrained(
+  const expr2tc &orig,
+  const expr2tc &expr)
+{
+  bool invertible;
+  switch(expr->expr_id)
+  {
+  case expr2t::add_id:
+  case expr2t::sub_id:
+  case expr2t::bitxor_id:
+  case expr2t::neg_id:
+  case expr2t::bitnot_id:
+    invertible = is_bv_type(expr);
+    break;
+  case expr2t::equality_id:
+  case expr2t::notequal_id:
+    invertible = is_bv_type(*expr->get_sub_expr(0));
+    break;
+  default:
+    invertible = false;
+  }
+
+  if(!invertible)
+    return expr;
+
+  // With an input used only here, each of these takes any value of its type
+  // whatever its other operand is.
+  bool found = false;
+  expr->foreach_operand([this, &found] (const expr2tc &e)
+    {
+      found = found || is_unconstrained(e);
+    }
+  );
+  if(!found)
+    return expr;
+
+  symbol2tc fresh(expr->type, "nondet$symex::unconstrained" +
+                              i2string(fresh_count++));
+  uses[fresh->get_symbol_name()] = parents[orig.get()];
+  ++unconstrained;
+  return fresh;
+}
+
+void symex_preprocesst::eliminate_unconstrained(SSA_stepst &steps)
+{
+  // Count uses of symbols, and of nodes, by the nodes that refer to them:
+  // a shared node is converted once, so it's one use.
+  std::unordered_set<const expr2t *> seen;
+  std::function<void (const expr2tc &)> count =
+    [this, &seen, &count] (const expr2tc &e)
+    {
+      if(is_nil_expr(e))
+        return;
+
+      ++parents[e.get()];
+      if(is_symbol2t(e))
+        ++uses[to_symbol2t(e).get_symbol_name()];
+
+      if(!seen.insert(e.get()).second)
+        return;
+
+      // What's under an opaque node stays as it is, so an input in there
+      // ties that node to any other use of it: it's not unconstrained.
+      if(is_opaque(e))
+      {
+        std::unordered_set<const expr2t *> pinned_seen;
+        get_symbols(e, pinned_seen, [this](const symbol2t &s)
+          {
+            defined.insert(s.get_symbol_name());
+          }
+        );
+      }
+
+      e->foreach_operand(count);
+    };
+
+  for(const auto &step : steps)
+  {
+    if(step.ignore)
+      continue;
+
+    count(step.guard);
+    if(step.is_assignment())
+    {
+      defined.insert(to_symbol2t(step.lhs).get_symbol_name());
+      count(step.rhs);
+    }
+    else if(step.is_renumber())
+    {
+      defined.insert(to_symbol2t(step.lhs).get_symbol_name());
+      count(step.lhs);
+      count(step.rhs);
+    }
+    else if(step.is_output())
+    {
+      for(const auto &arg : step.output_args)
+        count(arg);
+    }
+    else
+      count(step.cond);
+  }
+
+  memot memo;
+  postt post = [this](const expr2tc &orig, const expr2tc &e) -> expr2tc
+    {
+      return make_unconstrained(orig, e);
+    };
+
+  for(auto &step : steps)
+    if(!step.ignore)
+      rewrite_step(step, memo, post);
+
+  parents.clear();
+}
+
+void symex_preprocesst::remove_dead(SSA_stepst &steps)
+{
+  hash_set_cont<std::string, string_hash> live;
+  std::unordered_set<const expr2t *> seen;
+  std::function<void (const symbol2t &)> add_live =
+    [&live](const symbol2t &s) { live.insert(s.get_symbol_name()); };
+
+  for(SSA_stepst::reverse_iterator it = steps.rbegin();
+      it != steps.rend();
+      it++)
+  {
+    SSA_stept &step = *it;
+    if(step.ignore)
+      continue;
+
+    if(step.is_assignment() &&
+       step.assignment_type == symex_targett::HIDDEN &&
+       !live.count(to_symbol2t(step.lhs).get_symbol_name()))
+    {
+      step.ignore = true;
+      ++ignored;
+      continue;
+    }
+
+    // The guard decides whether a kept step is shown in a trace, so what it
+    // refers to has to be kept too.
+    get_symbols(step.guard, seen, add_live);
+    get_symbols(step.lhs, seen, add_live);
+    get_symbols(step.rhs, seen, add_live);
+    get_symbols(step.cond, seen, add_live);
+    for(const auto &arg : step.output_args)
+      get_symbols(arg, seen, add_live);
+  }
+}
+
+void symex_preprocesst::preprocess(
+  boost::shared_ptr<symex_target_equationt> &eq)
+{
+  collect_equalities(eq->SSA_steps);
+  propagate(eq->SSA_steps);
+
+  // Copies left behind by propagation still count as uses of the inputs
+  // they copy; drop them before looking for unconstrained terms.
+  remove_dead(eq->SSA_steps);
+  eliminate_unconstrained(eq->SSA_steps);
+  remove_dead(eq->SSA_steps);
+}
@@ -0,0 +1,101 @@
+/*******************************************************************\
+
+Module: Word-level preprocessing of symex equations
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_SSA_PREPROCESS_H
+#define CPROVER_GOTO_SYMEX_SSA_PREPROCESS_H
+
+#include <functional>
+#include <goto-symex/symex_target_equation.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <util/hash_cont.h>
+#include <util/union_find.h>
+
+/** Rewrites a (sliced) equation before it is converted, so that every solver
+ *  sees a smaller formula:
+ *
+ *  - symbols assigned from other symbols are replaced by the first symbol of
+ *    their equivalence class, and symbols assigned a constant by the constant;
+ *  - comparisons of two zero or sign extended operands, or of one and a
+ *    constant that fits, are made on the narrower operands;
+ *  - a term that an unconstrained input can make take any value, such as
+ *    x + e where x is a nondet used nowhere else, becomes a fresh input;
+ *  - hidden assignments nothing refers to any more are dropped.
+ *
+ *  Assignments a counterexample shows are kept, even once unused, and an
+ *  input is only taken as unconstrained if no shown value depends on it, so
+ *  that traces stay consistent. */
+class symex_preprocesst
+{
+public:
+  symex_preprocesst();
+  void preprocess(boost::shared_ptr<symex_target_equationt> &eq);
+
+  /** Symbols replaced by an equal symbol, and by a constant. */
+  unsigned int substituted, propagated;
+  /** Comparisons moved onto narrower operands. */
+  unsigned int narrowed;
+  /** Terms replaced by a fresh unconstrained input. */
+  unsigned int unconstrained;
+  /** Steps that are no longer needed, and have been ignored. */
+  BigInt ignored;
+
+  /** Whether the conversion of expr looks at the shape of its operands, as
+   *  overflow checks and pointer predicates do, so that they can't be
+   *  rewritten into anything else. */
+  static bool is_opaque(const expr2tc &expr);
+
+protected:
+  typedef symex_target_equationt::SSA_stept SSA_stept;
+  typedef symex_target_equationt::SSA_stepst SSA_stepst;
+
+  /** Results of rewriting the nodes of an expression DAG, by node. The
+   *  original is held on to, so that its address isn't reused. */
+  typedef std::unordered_map<const expr2t *, std::pair<expr2tc, expr2tc> >
+    memot;
+  typedef std::function<expr2tc (const expr2tc &, const expr2tc &)> postt;
+
+  /** Rebuild expr bottom up, calling post on every node with its original
+   *  and the node with its rewritten operands. Operands of opaque nodes are
+   *  left alone: those of address_of name objects rather than values, and
+   *  the others are converted by their shape. */
+  expr2tc rewrite(const expr2tc &expr, memot &memo, const postt &post);
+  void rewrite_step(SSA_stept &step, memot &memo, const postt &post);
+
+  void collect_equalities(SSA_stepst &steps);
+  void propagate(SSA_stepst &steps);
+  void eliminate_unconstrained(SSA_stepst &steps);
+  void remove_dead(SSA_stepst &steps);
+
+  expr2tc substitute(const expr2tc &expr);
+  expr2tc narrow(const expr2tc &expr);
+  expr2tc make_unconstrained(const expr2tc &orig, const expr2tc &expr);
+  bool is_unconstrained(const expr2tc &expr) const;
+
+  unsigned int number(const expr2tc &sym);
+  void get_symbols(const expr2tc &expr,
+                   std::unordered_set<const expr2t *> &seen,
+                   std::function<void (const symbol2t &)> fn);
+
+  /** Equivalence classes of symbols that are assigned to one another. The
+   *  representative of a class is its first member used as a right hand
+   *  side: the one whose definition the others are copies of. */
+  unsigned_union_find classes;
+  hash_map_cont<std::string, unsigned int, string_hash> numbers;
+  std::vector<expr2tc> symbols;
+  std::vector<expr2tc> representative;
+
+  /** Symbols known to be equal to a constant. */
+  hash_map_cont<std::string, expr2tc, string_hash> constants;
+  /** Symbols that are defined by a step. */
+  hash_set_cont<std::string, string_hash> defined;
+  /** Number of uses of each input symbol, and of each node. */
+  hash_map_cont<std::string, unsigned int, string_hash> uses;
+  std::unordered_map<const expr2t *, unsigned int> parents;
+  unsigned int fresh_count;
+};
+
+#endif
@@ -48,7 +48,8 @@ goto_symext::goto_symext(const namespacet &_ns, contextt &_new_context,
     || options.get_bool_option("k-induction-parallel")),
   base_case(options.get_bool_option("base-case")),
   forward_condition(options.get_bool_option("forward-condition")),
-  inductive_step(options.get_bool_option("inductive-step"))
+  inductive_step(options.get_bool_option("inductive-step")),
+  guard_literals(options.get_bool_option("guard-literals"))
 {
   const std::string &set = options.get_option("unwindset");
   unsigned int length = set.length();
@@ -109,6 +110,7 @@ goto_symext& goto_symext::operator=(const goto_symext &sym)
   base_case = sym.base_case;
   forward_condition = sym.forward_condition;
   inductive_step = sym.inductive_step;
+  guard_literals = sym.guard_literals;
   first_loop = sym.first_loop;
 
   valid_ptr_arr_name = sym.valid_ptr_arr_name;
@@ -178,9 +178,42 @@ goto_symext::symex_goto(const expr2tc &old_guard)
       cur_state->guard.add(guard_expr);
       new_state.guard.add(not_guard_expr);
     }
+
+    make_guard_literal(new_state.guard);
+    make_guard_literal(cur_state->guard);
   }
 }
 
+void
+goto_symext::make_guard_literal(guardt &guard)
+{
+  if (!guard_literals)
+    return;
+
+  // Only a conjunction of several guards can be named; a single one, even
+  // a disjunction left by a merge, is its own expression
+  if (guard.is_true() || guard.is_single_symbol())
+    return;
+
+  // Already named
+  expr2tc guard_expr = guard.as_expr();
+  if (is_symbol2t(guard_expr))
+    return;
+
+  expr2tc literal = guard_identifier();
+  cur_state->assignment(literal, guard_expr, false);
+
+  target->assignment(
+    gen_true_expr(),
+    literal, literal,
+    guard_expr,
+    cur_state->source,
+    cur_state->gen_stack_trace(),
+    symex_targett::HIDDEN);
+
+  guard.set_literal(literal);
+}
+
 void
 goto_symext::merge_gotos()
 {
@@ -215,6 +248,8 @@ goto_symext::merge_gotos()
     cur_state->depth = std::min(cur_state->depth, goto_state.depth);
   }
 
+  make_guard_literal(cur_state->guard);
+
   // clean up to save some memory
   frame.goto_state_map.erase(state_map_it);
 }
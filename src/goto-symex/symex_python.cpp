@@ -166,6 +166,17 @@ goto_trace_2_text(goto_tracet &trace, const namespacet &ns)
   return ss.str();
 }
 
+static void
+build_full_goto_trace(
+  const boost::shared_ptr<symex_target_equationt> &target,
+  boost::shared_ptr<smt_convt> &smt_conv,
+  goto_tracet &goto_trace)
+{
+  // Scripts look at every step, so fetch all values up front
+  build_goto_trace(target, smt_conv, goto_trace);
+  goto_trace.fetch_all_values();
+}
+
 static symex_targett::sourcet
 get_frame_source(const stack_framet &ref)
 {
@@ -308,7 +319,7 @@ build_goto_symex_classes()
 
   symex.attr("slice") = make_function(&::slice);
   symex.attr("simple_slice") = make_function(&::simple_slice);
-  symex.attr("build_goto_trace") = make_function(&build_goto_trace);
+  symex.attr("build_goto_trace") = make_function(&build_full_goto_trace);
 
   build_equation_class();
 
@@ -465,18 +465,12 @@ runtime_encoded_equationt::ask_solver_question(const expr2tc &question)
 
   // Now, how to ask the question? Unfortunately the clever solver stuff won't
   // negate the condition, it'll only give us a handle to it that it negates
-  // when we access. So, we have to make an assertion, check it, pop it, then
-  // check another.
-  // Those assertions are just is-the-prop-true, is-the-prop-false. Valid
-  // results are true, false, both.
-  push_ctx();
-  conv.assert_ast(q);
-  smt_convt::resultt res1 = conv.dec_solve();
-  pop_ctx();
-  push_ctx();
-  conv.assert_ast(conv.invert_ast(q));
-  smt_convt::resultt res2 = conv.dec_solve();
-  pop_ctx();
+  // when we access. So, we check under the assumption that it's true, then
+  // again assuming that it's false.
+  // Valid results are true, false, both.
+  smt_convt::resultt res1 = conv.dec_solve_assuming(smt_convt::ast_vec(1, q));
+  smt_convt::resultt res2 =
+    conv.dec_solve_assuming(smt_convt::ast_vec(1, conv.invert_ast(q)));
 
   // So; which result?
   if (res1 == smt_convt::P_ERROR || res1 == smt_convt::P_SMTLIB ||
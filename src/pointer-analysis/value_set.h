@@ -245,7 +245,7 @@ public:
   /** Type of the value-set containing structure. A hash map mapping variables
    *  to an entryt, storing the value set of objects a variable might point
    *  at. */
-  typedef hash_map_cont<string_wrapper, entryt, string_wrap_hash> valuest;
+  typedef flat_hash_map_cont<string_wrapper, entryt, string_wrap_hash> valuest;
 
   /** Get the natural alignment unit of a reference to e. I don't know a more
    *  appropriate term, but if we were to have an offset into e, then what is
@@ -86,7 +86,7 @@ boolector_convt::assert_ast(const smt_ast *a)
 }
 
 smt_ast *
-boolector_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
+boolector_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                                const smt_ast * const *args,
                                unsigned int numargs)
 {
@@ -198,7 +198,7 @@ boolector_convt::mk_sort(const smt_sort_kind k, ...)
     case SMT_SORT_SBV:
     {
       unsigned long uint = va_arg(ap, unsigned long);
-      return new boolector_smt_sort(k, boolector_bitvec_sort(btor, uint), uint);
+      return new (this) boolector_smt_sort(k, boolector_bitvec_sort(btor, uint), uint);
     }
     case SMT_SORT_ARRAY:
     {
@@ -213,12 +213,12 @@ boolector_convt::mk_sort(const smt_sort_kind k, ...)
       if (range->id == SMT_SORT_STRUCT || range->id == SMT_SORT_BOOL || range->id == SMT_SORT_UNION)
         data_width = 1;
 
-      return new boolector_smt_sort(k, boolector_array_sort(btor, dom->s, range->s),
+      return new (this) boolector_smt_sort(k, boolector_array_sort(btor, dom->s, range->s),
           data_width, dom->get_data_width(), range);
     }
 
     case SMT_SORT_BOOL:
-      return new boolector_smt_sort(k, boolector_bool_sort(btor));
+      return new (this) boolector_smt_sort(k, boolector_bool_sort(btor));
 
     case SMT_SORT_FLOATBV:
     {
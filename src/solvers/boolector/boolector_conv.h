@@ -62,7 +62,7 @@ public:
 
   void assert_ast(const smt_ast *a) override;
 
-  smt_ast *mk_func_app(const smt_sort *s, smt_func_kind k,
+  smt_ast *mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                                const smt_ast * const *args,
                                unsigned int numargs) override;
   smt_sortt mk_sort(const smt_sort_kind k, ...) override;
@@ -99,7 +99,7 @@ public:
   const smt_ast *overflow_arith(const expr2tc &expr) override;
 
   inline btor_smt_ast *new_ast(const smt_sort *_s, BoolectorNode *_e) {
-    return new btor_smt_ast(this, _s, _e);
+    return new (this) btor_smt_ast(this, _s, _e);
   }
 
   typedef BoolectorNode *(*shift_func_ptr)
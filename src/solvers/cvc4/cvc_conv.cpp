@@ -75,7 +75,7 @@ cvc_convt::get_array_elem(
   CVC4::Expr e = em.mkExpr(CVC4::kind::SELECT, carray->e, tmpa->e);
   free(tmpast);
 
-  cvc_smt_ast *tmpb = new cvc_smt_ast(this, convert_sort(subtype), e);
+  cvc_smt_ast *tmpb = new (this) cvc_smt_ast(this, convert_sort(subtype), e);
   expr2tc result = get_bv(subtype, tmpb);
   free(tmpb);
 
@@ -98,7 +98,7 @@ cvc_convt::assert_ast(const smt_ast *a)
 }
 
 smt_ast *
-cvc_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
+cvc_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                              const smt_ast * const *_args,
                              unsigned int numargs)
 {
@@ -220,7 +220,7 @@ cvc_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
     abort();
   }
 
-  return new cvc_smt_ast(this, s, e);
+  return new (this) cvc_smt_ast(this, s, e);
 }
 
 smt_sortt
@@ -231,13 +231,13 @@ cvc_convt::mk_sort(const smt_sort_kind k, ...)
   va_start(ap, k);
   switch (k) {
   case SMT_SORT_BOOL:
-    return new cvc_smt_sort(k, em.booleanType());
+    return new (this) cvc_smt_sort(k, em.booleanType());
   case SMT_SORT_FIXEDBV:
   case SMT_SORT_UBV:
   case SMT_SORT_SBV:
   {
     unsigned long uint = va_arg(ap, unsigned long);
-    return new cvc_smt_sort(k, em.mkBitVectorType(uint), uint);
+    return new (this) cvc_smt_sort(k, em.mkBitVectorType(uint), uint);
   }
   case SMT_SORT_ARRAY:
   {
@@ -251,7 +251,7 @@ cvc_convt::mk_sort(const smt_sort_kind k, ...)
     if (range->id == SMT_SORT_STRUCT || range->id == SMT_SORT_BOOL || range->id == SMT_SORT_UNION)
       data_width = 1;
 
-    return new cvc_smt_sort(k, em.mkArrayType(dom->s, range->s), data_width,
+    return new (this) cvc_smt_sort(k, em.mkArrayType(dom->s, range->s), data_width,
                             dom->get_data_width(), range);
     break;
   }
@@ -289,7 +289,7 @@ cvc_convt::mk_smt_bvint(const mp_integer &theint, bool sign, unsigned int width)
   // assume CVC is going to cut the top off correctly.
   CVC4::BitVector bv = CVC4::BitVector(width, (unsigned long int)theint.to_int64());
   CVC4::Expr e = em.mkConst(bv);
-  return new cvc_smt_ast(this, s, e);
+  return new (this) cvc_smt_ast(this, s, e);
 }
 
 smt_ast *
@@ -297,7 +297,7 @@ cvc_convt::mk_smt_bool(bool val)
 {
   const smt_sort *s = boolean_sort;
   CVC4::Expr e = em.mkConst(val);
-  return new cvc_smt_ast(this, s, e);
+  return new (this) cvc_smt_ast(this, s, e);
 }
 
 smt_ast *
@@ -321,13 +321,13 @@ cvc_convt::mk_smt_symbol(const std::string &name, const smt_sort *s)
   // from the symbol table. If not, time for a new name.
   if (sym_tab.isBound(name)) {
     CVC4::Expr e = sym_tab.lookup(name);
-    return new cvc_smt_ast(this, s, e);
+    return new (this) cvc_smt_ast(this, s, e);
   }
 
   // Time for a new one.
   CVC4::Expr e = em.mkVar(name, sort->s); // "global", eh?
   sym_tab.bind(name, e, true);
-  return new cvc_smt_ast(this, s, e);
+  return new (this) cvc_smt_ast(this, s, e);
 }
 
 smt_sort *
@@ -344,7 +344,7 @@ cvc_convt::mk_extract(const smt_ast *a, unsigned int high,
   CVC4::BitVectorExtract ext(high, low);
   CVC4::Expr ext2 = em.mkConst(ext);
   CVC4::Expr fin = em.mkExpr(CVC4::Kind::BITVECTOR_EXTRACT, ext2, ca->e);
-  return new cvc_smt_ast(this, s, fin);
+  return new (this) cvc_smt_ast(this, s, fin);
 }
 
 const smt_ast *
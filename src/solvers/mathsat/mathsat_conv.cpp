@@ -217,7 +217,7 @@ mathsat_convt::get_array_elem(
   msat_term t = msat_make_array_read(env, mast->t, tmpa->t);
   check_msat_error(t);
 
-  mathsat_smt_ast *tmpb = new mathsat_smt_ast(this, convert_sort(subtype), t);
+  mathsat_smt_ast *tmpb = new (this) mathsat_smt_ast(this, convert_sort(subtype), t);
   expr2tc result = get_bv(subtype, tmpb);
   free(tmpb);
 
@@ -237,7 +237,7 @@ mathsat_convt::solver_text()
 }
 
 smt_ast *
-mathsat_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
+mathsat_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                              const smt_ast * const *_args,
                              unsigned int numargs)
 {
@@ -493,7 +493,7 @@ mathsat_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
   }
   check_msat_error(r);
 
-  return new mathsat_smt_ast(this, s, r);
+  return new (this) mathsat_smt_ast(this, s, r);
 }
 
 smt_sortt
@@ -504,15 +504,15 @@ mathsat_convt::mk_sort(const smt_sort_kind k, ...)
   va_start(ap, k);
   switch (k) {
   case SMT_SORT_INT:
-    return new mathsat_smt_sort(k, msat_get_integer_type(env));
+    return new (this) mathsat_smt_sort(k, msat_get_integer_type(env));
   case SMT_SORT_REAL:
-    return new mathsat_smt_sort(k, msat_get_rational_type(env));
+    return new (this) mathsat_smt_sort(k, msat_get_rational_type(env));
   case SMT_SORT_FIXEDBV:
   case SMT_SORT_UBV:
   case SMT_SORT_SBV:
   {
     unsigned long uint = va_arg(ap, unsigned long);
-    return new mathsat_smt_sort(k, msat_get_bv_type(env, uint), uint);
+    return new (this) mathsat_smt_sort(k, msat_get_bv_type(env, uint), uint);
   }
   case SMT_SORT_FLOATBV:
   {
@@ -521,7 +521,7 @@ mathsat_convt::mk_sort(const smt_sort_kind k, ...)
     return mk_fpbv_sort(ew, sw);
   }
   case SMT_SORT_FLOATBV_RM:
-    return new mathsat_smt_sort(k, msat_get_fp_roundingmode_type(env));
+    return new (this) mathsat_smt_sort(k, msat_get_fp_roundingmode_type(env));
   case SMT_SORT_ARRAY:
   {
     const mathsat_smt_sort *dom = va_arg(ap, const mathsat_smt_sort *);
@@ -534,13 +534,13 @@ mathsat_convt::mk_sort(const smt_sort_kind k, ...)
     if (range->id == SMT_SORT_STRUCT || range->id == SMT_SORT_BOOL || range->id == SMT_SORT_UNION)
       data_width = 1;
 
-    return new mathsat_smt_sort(k, msat_get_array_type(env, dom->s, range->s),
+    return new (this) mathsat_smt_sort(k, msat_get_array_type(env, dom->s, range->s),
                                 data_width, dom->get_data_width(), range);
   }
   case SMT_SORT_BOOL:
   {
 
-    auto b = new mathsat_smt_sort(k, msat_get_bool_type(env));
+    auto b = new (this) mathsat_smt_sort(k, msat_get_bool_type(env));
     std::cout << b << std::endl;
     return b;
   }
@@ -565,7 +565,7 @@ mathsat_convt::mk_smt_int(const mp_integer &theint, bool sign __attribute__((unu
   check_msat_error(t);
 
   smt_sortt s = mk_sort(SMT_SORT_INT);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_ast *
@@ -575,7 +575,7 @@ mathsat_convt::mk_smt_real(const std::string &str)
   check_msat_error(t);
 
   smt_sortt s = mk_sort(SMT_SORT_REAL);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt
@@ -591,7 +591,7 @@ mathsat_convt:: mk_smt_bvint(const mp_integer &theint, bool sign, unsigned int w
   check_msat_error(t);
 
   smt_sortt s = mk_sort(ctx->int_encoding ? SMT_SORT_INT : sign ? SMT_SORT_SBV : SMT_SORT_UBV, w);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv(const ieee_floatt &thereal)
@@ -618,7 +618,7 @@ smt_astt mathsat_convt::mk_smt_fpbv(const ieee_floatt &thereal)
   migrate_type(thereal.spec.to_type(), new_fp_type);
   smt_sortt s = convert_sort(new_fp_type);
 
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv_nan(unsigned ew, unsigned sw)
@@ -627,7 +627,7 @@ smt_astt mathsat_convt::mk_smt_fpbv_nan(unsigned ew, unsigned sw)
   check_msat_error(t);
 
   smt_sortt s = mk_sort(SMT_SORT_FLOATBV, ew, sw);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv_inf(bool sgn, unsigned ew, unsigned sw)
@@ -637,7 +637,7 @@ smt_astt mathsat_convt::mk_smt_fpbv_inf(bool sgn, unsigned ew, unsigned sw)
   check_msat_error(t);
 
   smt_sortt s = mk_sort(SMT_SORT_FLOATBV, ew, sw);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv_rm(ieee_floatt::rounding_modet rm)
@@ -663,7 +663,7 @@ smt_astt mathsat_convt::mk_smt_fpbv_rm(ieee_floatt::rounding_modet rm)
   check_msat_error(t);
 
   smt_sortt s = mk_sort(SMT_SORT_FLOATBV_RM);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_typecast_from_fpbv(const typecast2t &cast)
@@ -702,7 +702,7 @@ smt_astt mathsat_convt::mk_smt_typecast_from_fpbv(const typecast2t &cast)
   check_msat_error(t);
   assert(s != nullptr);
 
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_typecast_to_fpbv(const typecast2t &cast)
@@ -740,7 +740,7 @@ smt_astt mathsat_convt::mk_smt_typecast_to_fpbv(const typecast2t &cast)
     t = msat_make_fp_cast(env, ew, sw, mrm->t, mfrom->t);
 
   check_msat_error(t);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_nearbyint_from_float(const nearbyint2t& expr)
@@ -757,7 +757,7 @@ smt_astt mathsat_convt::mk_smt_nearbyint_from_float(const nearbyint2t& expr)
   check_msat_error(t);
 
   smt_sortt s = convert_sort(expr.type);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv_arith_ops(const expr2tc& expr)
@@ -808,7 +808,7 @@ smt_astt mathsat_convt::mk_smt_fpbv_arith_ops(const expr2tc& expr)
   check_msat_error(t);
 
   smt_sortt s = convert_sort(expr->type);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_astt mathsat_convt::mk_smt_fpbv_fma(const expr2tc& expr)
@@ -820,7 +820,7 @@ smt_ast *
 mathsat_convt::mk_smt_bool(bool val)
 {
   const smt_sort *s = boolean_sort;
-  return new mathsat_smt_ast(this, s, (val) ? msat_make_true(env)
+  return new (this) mathsat_smt_ast(this, s, (val) ? msat_make_true(env)
                                       : msat_make_false(env));
 }
 
@@ -841,7 +841,7 @@ mathsat_convt::mk_smt_symbol(const std::string &name, const smt_sort *s)
 
   msat_term t = msat_make_constant(env, d);
   check_msat_error(t);
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 smt_sort *
@@ -862,14 +862,14 @@ mathsat_convt::mk_extract(const smt_ast *a, unsigned int high,
     msat_term t = msat_make_fp_as_ieeebv(env, mast->t);
     check_msat_error(t);
 
-    smt_ast * bv = new mathsat_smt_ast(this, s, t);
+    smt_ast * bv = new (this) mathsat_smt_ast(this, s, t);
     mast = mathsat_ast_downcast(bv);
   }
 
   msat_term t = msat_make_bv_extract(env, high, low, mast->t);
   check_msat_error(t);
 
-  return new mathsat_smt_ast(this, s, t);
+  return new (this) mathsat_smt_ast(this, s, t);
 }
 
 const smt_ast *
@@ -910,7 +910,7 @@ void mathsat_smt_ast::dump() const
 smt_sortt mathsat_convt::mk_fpbv_sort(const unsigned ew, const unsigned sw)
 {
   return
-    new mathsat_smt_sort(SMT_SORT_FLOATBV, msat_get_fp_type(env, ew, sw), ew + sw, sw);
+    new (this) mathsat_smt_sort(SMT_SORT_FLOATBV, msat_get_fp_type(env, ew, sw), ew + sw, sw);
 }
 
 void mathsat_convt::dump_smt()
@@ -55,7 +55,7 @@ public:
 
   void assert_ast(const smt_ast *a) override;
 
-  smt_ast *mk_func_app(const smt_sort *s, smt_func_kind k,
+  smt_ast *mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                                const smt_ast * const *args,
                                unsigned int numargs) override;
   smt_sortt mk_sort(const smt_sort_kind k, ...) override;
@@ -21,9 +21,9 @@ bitblast_convt::assert_ast(smt_astt a)
 }
 
 smt_astt
-bitblast_convt::mk_func_app(smt_sortt ressort,
-                            smt_func_kind f, const smt_ast* const* _args,
-                            unsigned int numargs)
+bitblast_convt::mk_func_app_impl(smt_sortt ressort,
+                                 smt_func_kind f, const smt_ast* const* _args,
+                                 unsigned int numargs)
 {
   const bitblast_smt_ast *args[4];
   bitblast_smt_ast *result = NULL;
@@ -291,15 +291,15 @@ bitblast_convt::mk_sort(smt_sort_kind k, ...)
   case SMT_SORT_BV:
     uint = va_arg(ap, unsigned long);
     thebool = va_arg(ap, int);
-    s = new bitblast_smt_sort(k, uint, thebool);
+    s = new (this) bitblast_smt_sort(k, uint, thebool);
     break;
   case SMT_SORT_ARRAY:
     dom = va_arg(ap, bitblast_smt_sort *); // Consider constness?
     range = va_arg(ap, bitblast_smt_sort *);
-    s = new bitblast_smt_sort(k, range->data_width, dom->data_width);
+    s = new (this) bitblast_smt_sort(k, range->data_width, dom->data_width);
     break;
   case SMT_SORT_BOOL:
-    s = new bitblast_smt_sort(k);
+    s = new (this) bitblast_smt_sort(k);
     break;
   default:
     std::cerr << "Unimplemented SMT sort " << k << " in bitblaster conversion"
@@ -65,8 +65,8 @@ public:
 
   // smt_convt apis we fufil
 
-  virtual smt_astt mk_func_app(const smt_sort *ressort, smt_func_kind f,
-                               const smt_ast* const* args, unsigned int num);
+  virtual smt_astt mk_func_app_impl(const smt_sort *ressort, smt_func_kind f,
+                                    const smt_ast* const* args, unsigned int num);
   virtual smt_sort* mk_sort(smt_sort_kind k, ...);
   virtual smt_ast* mk_smt_int(const mp_integer &intval, bool sign);
   virtual smt_ast* mk_smt_real(const std::string &value);
@@ -123,7 +123,7 @@ public:
   bool is_constant(const bvt &bv);
 
   inline bitblast_smt_ast *new_ast(smt_sortt ressort) {
-    return new bitblast_smt_ast(this, ressort);
+    return new (this) bitblast_smt_ast(this, ressort);
   }
 
   // Members
@@ -1,7 +1,10 @@
 #include <algorithm>
+#include <map>
 #include <set>
 #include <solvers/smt/array_conv.h>
+#include <sstream>
 #include <util/c_types.h>
+#include <util/irep2_utils.h>
 #include <utility>
 
 static inline bool
@@ -20,8 +23,9 @@ array_indexes_are_same(
   return true;
 }
 
-array_convt::array_convt(smt_convt *_ctx)
- : array_iface(true, true), ctx(_ctx)
+array_convt::array_convt(smt_convt *_ctx, bool _lazy)
+ : array_iface(true, true), lazy(_lazy), num_refinements(0), num_lemmas(0),
+   needs_encoding(false), ctx(_ctx)
 {
 }
 
@@ -48,6 +52,7 @@ unsigned int
 array_convt::new_array_id()
 {
   unsigned int new_base_array_id = array_indexes.size();
+  needs_encoding = true;
 
   // Pouplate tracking data with empt containers
   idx_record_containert tmp_set;
@@ -225,6 +230,7 @@ array_convt::mk_unbounded_select(const array_ast *ma,
   // value.
 
   // Record that we've accessed this index.
+  needs_encoding = true;
   idx_record new_idx_rec = { real_idx, ctx->ctx_level };
   array_indexes[ma->base_array_id].insert(new_idx_rec);
 
@@ -279,6 +285,7 @@ array_convt::mk_unbounded_store(const array_ast *ma,
   // array at the end of conversion so that they're all consistent.
 
   // Record that we've accessed this index.
+  needs_encoding = true;
   idx_record new_idx_rec = { idx, ctx->ctx_level };
   array_indexes[ma->base_array_id].insert(new_idx_rec);
 
@@ -346,6 +353,7 @@ array_convt::unbounded_array_ite(smt_astt cond,
 
   unsigned int new_arr_id =
     std::min(true_arr->base_array_id, false_arr->base_array_id); // yolo
+  needs_encoding = true;
 
   array_ast *newarr = new_ast(thesort);
   newarr->base_array_id = new_arr_id;
@@ -424,6 +432,7 @@ array_convt::encode_array_equality(const array_ast *a1, const array_ast *a2)
   e.result = ctx->mk_fresh(ctx->boolean_sort, "");
 
   array_equalities.insert(std::make_pair(ctx->ctx_level, e));
+  needs_encoding = true;
   return e.result;
 }
 
@@ -486,12 +495,158 @@ array_convt::get_array_elem(smt_astt a, uint64_t index, const type2tc &subtype)
 void
 array_convt::add_array_constraints_for_solving()
 {
+  if (!needs_encoding)
+    return;
 
   join_array_indexes();
   add_new_indexes();
   execute_new_updates();
   apply_new_selects();
   add_array_equalities();
+  needs_encoding = false;
+}
+
+bool
+array_convt::refine_array_model()
+{
+  if (!lazy)
+    return false;
+
+  // Work out every lemma the model breaks before asserting any: some solvers
+  // drop their model on the first new assertion.
+  model_cachet cache;
+  ast_vect lemmas;
+
+  for (unsigned int arrid = 0; arrid < array_valuation.size(); arrid++) {
+    if (is_lazy(arrid))
+      add_ackerman_lemmas(arrid, cache, lemmas);
+  }
+
+  for (auto const &u : lazy_updates)
+    add_frame_lemmas(u, cache, lemmas);
+
+  if (lemmas.empty())
+    return false;
+
+  for (smt_astt l : lemmas)
+    ctx->assert_ast(l);
+
+  num_refinements++;
+  num_lemmas += lemmas.size();
+
+  std::stringstream ss;
+  ss << "Array refinement " << num_refinements << ": " << lemmas.size()
+     << " lemmas (" << num_lemmas << " in total)";
+  ctx->print(9, ss.str());
+  return true;
+}
+
+bool
+array_convt::is_lazy(unsigned int array_id) const
+{
+  // Only values of these sorts can be read back out of a model for checking.
+  unsigned int checkable = SMT_SORT_BOOL | SMT_SORT_UBV | SMT_SORT_SBV;
+  return lazy && array_id < array_subtypes.size() &&
+         (array_subtypes[array_id]->id & checkable) != 0;
+}
+
+expr2tc
+array_convt::model_value(smt_astt a, model_cachet &cache)
+{
+  auto it = cache.find(a);
+  if (it != cache.end())
+    return it->second;
+
+  expr2tc v;
+  if (a->sort->id == SMT_SORT_BOOL)
+    v = ctx->get_bool(a);
+  else
+    v = ctx->get_bv(get_uint_type(a->sort->get_data_width()), a);
+
+  cache.insert(std::make_pair(a, v));
+  return v;
+}
+
+void
+array_convt::add_ackerman_lemmas(unsigned int array_id, model_cachet &cache,
+                                 ast_vect &lemmas)
+{
+  // Group the initial elements by the value the model gives their index. Each
+  // one that differs from the first of its group needs that ackerman
+  // constraint; with them all, equal indexes have equal values transitively.
+  // Values the solver left unassigned are free, and can't break anything.
+  const ast_vect &vals = array_valuation[array_id][0];
+  std::map<expr2tc, std::pair<smt_astt, unsigned int> > first_with_idx;
+
+  for (auto const &it : expr_index_map[array_id]) {
+    if (it.vec_idx >= vals.size())
+      continue;
+
+    smt_astt idx = ctx->convert_ast(it.idx);
+    expr2tc idx_val = model_value(idx, cache);
+    if (is_nil_expr(idx_val))
+      continue;
+
+    auto res = first_with_idx.insert(
+      std::make_pair(idx_val, std::make_pair(idx, it.vec_idx)));
+    if (res.second)
+      continue;
+
+    smt_astt first_idx = res.first->second.first;
+    unsigned int first = res.first->second.second;
+    expr2tc v1 = model_value(vals[first], cache);
+    expr2tc v2 = model_value(vals[it.vec_idx], cache);
+    if (is_nil_expr(v1) || is_nil_expr(v2) || v1 == v2)
+      continue;
+
+    smt_astt idxeq = idx->eq(ctx, first_idx);
+    smt_astt valeq = vals[it.vec_idx]->eq(ctx, vals[first]);
+    lemmas.push_back(ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_IMPLIES,
+                                      idxeq, valeq));
+  }
+}
+
+void
+array_convt::add_frame_lemmas(const struct lazy_update &u,
+                              model_cachet &cache, ast_vect &lemmas)
+{
+  // Evaluate the update in the model, element by element, and keep the frame
+  // conditions of the elements that came out wrong.
+  const array_with &w = get_array_update(u.array_id, u.update_num);
+  const ast_vect &dest = array_valuation[u.array_id][u.update_num];
+  const ast_vect &src =
+    array_valuation[u.array_id][w.u.w.src_array_update_num];
+  const index_map_containert &idx_map = expr_index_map[u.array_id];
+
+  auto it = idx_map.find(w.idx);
+  assert(it != idx_map.end());
+  unsigned int updated_idx = it->vec_idx;
+
+  smt_astt update_idx_ast = ctx->convert_ast(w.idx);
+  expr2tc update_idx_val = model_value(update_idx_ast, cache);
+  if (is_nil_expr(update_idx_val))
+    return;
+
+  for (auto const &it2 : idx_map) {
+    if (it2.vec_idx == updated_idx || it2.vec_idx < u.start_point ||
+        it2.vec_idx >= dest.size())
+      continue;
+
+    smt_astt idx = ctx->convert_ast(it2.idx);
+    expr2tc idx_val = model_value(idx, cache);
+    if (is_nil_expr(idx_val))
+      continue;
+
+    smt_astt expected =
+      (idx_val == update_idx_val) ? w.u.w.val : src[it2.vec_idx];
+    expr2tc v1 = model_value(expected, cache);
+    expr2tc v2 = model_value(dest[it2.vec_idx], cache);
+    if (is_nil_expr(v1) || is_nil_expr(v2) || v1 == v2)
+      continue;
+
+    lemmas.push_back(frame_condition(update_idx_ast, idx, w.u.w.val,
+                                     src[it2.vec_idx], dest[it2.vec_idx]));
+  }
 }
 
 void
@@ -582,6 +737,13 @@ array_convt::pop_array_ctx()
     ctx_level_idx.erase(target_ctx);
   }
 
+  lazy_updates.erase(
+    std::remove_if(lazy_updates.begin(), lazy_updates.end(),
+                   [target_ctx](const struct lazy_update &u) {
+                     return u.ctx_level == target_ctx;
+                   }),
+    lazy_updates.end());
+
   // And now, in an intensely expensive operation, resize all the array value
   // vectors if they've had a change in number of indexes.
   for (unsigned int arrid = 0; arrid < array_updates.size(); arrid++) {
@@ -792,9 +954,10 @@ array_convt::add_new_indexes()
           start_pos[arrid]);
     }
 
-    // Apply inital ackerman constraints
-    add_initial_ackerman_constraints(array_values[0], expr_index_map[arrid],
-        start_pos[arrid]);
+    // Apply inital ackerman constraints, unless they're left to refinement
+    if (!is_lazy(arrid))
+      add_initial_ackerman_constraints(array_values[0], expr_index_map[arrid],
+          start_pos[arrid]);
 
     // And finally, re-execute the relevant array transitions
     for (unsigned int i = 0; i < array_updates[arrid].size() - 1; i++)
@@ -1001,6 +1164,15 @@ array_convt::execute_array_trans(array_update_vect &data,
       execute_array_ite(dest_data, data[true_idx], data[false_idx],
                         expr_index_map[arr], w.u.i.cond, start_point);
     }
+  } else if (is_lazy(arr)) {
+    // Only bind the updated element; the conditions on the rest are left to
+    // refine_array_model.
+    auto it = expr_index_map[arr].find(w.idx);
+    assert(it != expr_index_map[arr].end());
+    dest_data[it->vec_idx] = w.u.w.val;
+
+    struct lazy_update u = { arr, idx + 1, start_point, ctx->ctx_level };
+    lazy_updates.push_back(u);
   } else {
     execute_array_update(dest_data, data[w.u.w.src_array_update_num],
                          expr_index_map[arr], w.idx, w.u.w.val, start_point);
@@ -1038,17 +1210,27 @@ array_convt::execute_array_update(ast_vect &dest_data,
     if (it2.vec_idx < start_point)
       continue;
 
-    // Generate an ITE. If the index is nondeterministically equal to the
-    // current index, take the updated value, otherwise the original value.
-    // This departs from the CBMC implementation, in that they explicitly
-    // use implies and ackerman constraints.
-    // FIXME: benchmark the two approaches. For now, this is shorter.
-    smt_astt cond = update_idx_ast->eq(ctx, ctx->convert_ast(it2.idx));
-    smt_astt dest_ite = updated_value->ite(ctx, cond, source_data[it2.vec_idx]);
-    ctx->assert_ast(dest_data[it2.vec_idx]->eq(ctx, dest_ite));
+    ctx->assert_ast(frame_condition(update_idx_ast,
+                                    ctx->convert_ast(it2.idx), updated_value,
+                                    source_data[it2.vec_idx],
+                                    dest_data[it2.vec_idx]));
   }
+}
 
-  }
+smt_astt
+array_convt::frame_condition(smt_astt update_idx, smt_astt idx,
+                             smt_astt updated_value, smt_astt old_value,
+                             smt_astt new_value)
+{
+  // Generate an ITE. If the index is nondeterministically equal to the
+  // current index, take the updated value, otherwise the original value.
+  // This departs from the CBMC implementation, in that they explicitly
+  // use implies and ackerman constraints.
+  // FIXME: benchmark the two approaches. For now, this is shorter.
+  smt_astt cond = update_idx->eq(ctx, idx);
+  smt_astt dest_ite = updated_value->ite(ctx, cond, old_value);
+  return new_value->eq(ctx, dest_ite);
+}
 
 void
 array_convt::execute_array_ite(ast_vect &dest,
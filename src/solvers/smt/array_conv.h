@@ -18,6 +18,7 @@
 
 #include <set>
 #include <solvers/smt/smt_conv.h>
+#include <unordered_map>
 #include <util/irep2.h>
 
 static inline bool
@@ -79,6 +80,7 @@ class array_convt : public array_iface
 public:
   struct array_select;
   struct array_with;
+  struct lazy_update;
   typedef smt_convt::ast_vec ast_vect;
   typedef std::vector<ast_vect> array_update_vect;
 
@@ -103,7 +105,7 @@ public:
     >
   > index_map_containert;
 
-  array_convt(smt_convt *_ctx);
+  array_convt(smt_convt *_ctx, bool _lazy = false);
   ~array_convt() = default;
 
   // Public api
@@ -114,6 +116,7 @@ public:
   smt_astt convert_array_of(smt_astt init_val,
                                           unsigned long domain_width) override;
   void add_array_constraints_for_solving() override;
+  bool refine_array_model() override;
 
   // Heavy lifters
   virtual smt_astt convert_array_of_wsort(
@@ -182,18 +185,31 @@ public:
                             smt_astt init_val = nullptr);
   void add_initial_ackerman_constraints(const ast_vect &vals,
       const index_map_containert &idx_map, unsigned int start_point);
+  smt_astt frame_condition(smt_astt update_idx, smt_astt idx,
+                           smt_astt updated_value, smt_astt old_value,
+                           smt_astt new_value);
+
+  // Lemmas on demand
+
+  typedef std::unordered_map<smt_astt, expr2tc> model_cachet;
+  bool is_lazy(unsigned int array_id) const;
+  expr2tc model_value(smt_astt a, model_cachet &cache);
+  void add_ackerman_lemmas(unsigned int array_id, model_cachet &cache,
+                           ast_vect &lemmas);
+  void add_frame_lemmas(const struct lazy_update &u, model_cachet &cache,
+                        ast_vect &lemmas);
   void add_new_indexes();
   void execute_new_updates();
   void apply_new_selects();
 
   inline array_ast *
   new_ast(smt_sortt _s) {
-    return new array_ast(this, ctx, _s);
+    return new (ctx) array_ast(this, ctx, _s);
   }
 
   inline array_ast *
   new_ast(smt_sortt _s, const std::vector<smt_astt> &_a) {
-    return new array_ast(this, ctx, _s, _a);
+    return new (ctx) array_ast(this, ctx, _s, _a);
   }
 
   void push_array_ctx() override;
@@ -393,6 +409,31 @@ public:
   // indexed by the context level.
   std::vector<unsigned int> num_arrays_history;
 
+  // With lazy set, the two quadratic parts of the encoding are left out of the
+  // formula for arrays of bitvectors and bools: the ackerman constraints
+  // between the initial elements, and the conditions that an update leaves
+  // every element but the updated one alone. refine_array_model then asserts
+  // only those that a model breaks, until there are none; array equalities
+  // and ITEs are still encoded up front. Updates whose conditions were left
+  // out are recorded here.
+  struct lazy_update {
+    unsigned int array_id;
+    unsigned int update_num;
+    unsigned int start_point;
+    unsigned int ctx_level;
+  };
+
+  bool lazy;
+  std::vector<struct lazy_update> lazy_updates;
+  unsigned int num_refinements;
+  unsigned int num_lemmas;
+
+  // Whether any array operation has been recorded since constraints were last
+  // added for solving. Re-solving after a refinement must not encode
+  // everything at this context level a second time. Pushes and pops leave
+  // it alone: what was recorded before a push is still to be encoded after.
+  bool needs_encoding;
+
   // Finally, for model building, we need all the past array values. Three
   // vectors, dimensions are arrays id's, historical point, array element,
   // respectively.
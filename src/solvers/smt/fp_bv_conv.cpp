@@ -0,0 +1,874 @@
+#include <solvers/smt/fp_bv_conv.h>
+#include <util/arith_tools.h>
+#include <util/irep2_utils.h>
+
+// Number of bits needed to hold n.
+static unsigned int
+address_bits(unsigned int n)
+{
+  unsigned int bits = 1;
+  while ((n >> bits) != 0)
+    bits++;
+  return bits;
+}
+
+// Exponents are worked on signed, wide enough for the largest sum an
+// operation forms plus every normalization shift of a frac_width significand.
+static unsigned int
+exp_width_for(unsigned int ew, unsigned int frac_width)
+{
+  return std::max(ew, address_bits(frac_width)) + 4;
+}
+
+static mp_integer
+bias_of(unsigned ew)
+{
+  return power(2, ew - 1) - 1;
+}
+
+fp_bv_convt::fp_bv_convt(smt_convt *_ctx) : fp_convt(_ctx)
+{
+}
+
+smt_sortt
+fp_bv_convt::bv_sort(unsigned int width)
+{
+  return ctx->mk_sort(SMT_SORT_UBV, width);
+}
+
+smt_astt
+fp_bv_convt::bv_const(const mp_integer &val, unsigned int width)
+{
+  mp_integer v = val;
+  if (v.is_negative())
+    v += power(2, width);
+
+  // Not every solver takes literals wider than 64 bits.
+  if (width > 64) {
+    mp_integer chunk = power(2, 64);
+    return concat(bv_const(v / chunk, width - 64), bv_const(v % chunk, 64));
+  }
+
+  return ctx->mk_smt_bvint(v, false, width);
+}
+
+smt_astt
+fp_bv_convt::extract(smt_astt a, unsigned int high, unsigned int low)
+{
+  assert(high >= low && high < width(a));
+  return ctx->mk_extract(a, high, low, bv_sort(high - low + 1));
+}
+
+smt_astt
+fp_bv_convt::concat(smt_astt hi, smt_astt lo)
+{
+  smt_sortt s = bv_sort(width(hi) + width(lo));
+  return ctx->mk_func_app(s, SMT_FUNC_CONCAT, hi, lo);
+}
+
+smt_astt
+fp_bv_convt::zext(smt_astt a, unsigned int w)
+{
+  assert(w >= width(a));
+  if (w == width(a))
+    return a;
+
+  return concat(bv_const(0, w - width(a)), a);
+}
+
+smt_astt
+fp_bv_convt::bvop(smt_func_kind k, smt_astt a, smt_astt b)
+{
+  return ctx->mk_func_app(a->sort, k, a, b);
+}
+
+smt_astt
+fp_bv_convt::pred(smt_func_kind k, smt_astt a, smt_astt b)
+{
+  return ctx->mk_func_app(ctx->boolean_sort, k, a, b);
+}
+
+smt_astt
+fp_bv_convt::ite(smt_astt cond, smt_astt t, smt_astt f)
+{
+  return ctx->mk_func_app(t->sort, SMT_FUNC_ITE, cond, t, f);
+}
+
+smt_astt
+fp_bv_convt::lnot(smt_astt a)
+{
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_NOT, a);
+}
+
+smt_astt
+fp_bv_convt::land(smt_astt a, smt_astt b)
+{
+  return pred(SMT_FUNC_AND, a, b);
+}
+
+smt_astt
+fp_bv_convt::lor(smt_astt a, smt_astt b)
+{
+  return pred(SMT_FUNC_OR, a, b);
+}
+
+smt_astt
+fp_bv_convt::lxor(smt_astt a, smt_astt b)
+{
+  return pred(SMT_FUNC_XOR, a, b);
+}
+
+smt_astt
+fp_bv_convt::eq(smt_astt a, smt_astt b)
+{
+  return pred(SMT_FUNC_EQ, a, b);
+}
+
+smt_astt
+fp_bv_convt::bit(smt_astt a, unsigned int idx)
+{
+  return eq(extract(a, idx, idx), bv_const(1, 1));
+}
+
+smt_astt
+fp_bv_convt::is_zero(smt_astt a)
+{
+  return eq(a, bv_const(0, width(a)));
+}
+
+smt_astt
+fp_bv_convt::is_rm(smt_astt rm, ieee_floatt::rounding_modet mode)
+{
+  return eq(rm, bv_const(mode, 2));
+}
+
+smt_astt
+fp_bv_convt::shift_distance(smt_astt dist, unsigned int limit,
+                            unsigned int w)
+{
+  unsigned int dw = width(dist);
+  assert(address_bits(limit) < dw && address_bits(limit) <= w);
+
+  smt_astt lim = bv_const(limit, dw);
+  smt_astt d = ite(pred(SMT_FUNC_BVUGT, dist, lim), lim, dist);
+
+  if (dw < w)
+    return zext(d, w);
+  if (dw > w)
+    return extract(d, w - 1, 0);
+  return d;
+}
+
+smt_astt
+fp_bv_convt::sticky_shr(smt_astt a, smt_astt dist)
+{
+  smt_astt shifted = bvop(SMT_FUNC_BVLSHR, a, dist);
+  smt_astt lost = lnot(eq(bvop(SMT_FUNC_BVSHL, shifted, dist), a));
+  smt_astt sticky = zext(ite(lost, bv_const(1, 1), bv_const(0, 1)), width(a));
+  return bvop(SMT_FUNC_BVOR, shifted, sticky);
+}
+
+smt_astt
+fp_bv_convt::sign_of(smt_astt x)
+{
+  return bit(x, width(x) - 1);
+}
+
+smt_astt
+fp_bv_convt::magnitude_of(smt_astt x)
+{
+  return extract(x, width(x) - 2, 0);
+}
+
+smt_astt
+fp_bv_convt::is_nan(smt_astt x, unsigned ew, unsigned sw)
+{
+  smt_astt exp = extract(x, ew + sw - 1, sw);
+  smt_astt frac = extract(x, sw - 1, 0);
+  return land(eq(exp, bv_const(power(2, ew) - 1, ew)), lnot(is_zero(frac)));
+}
+
+smt_astt
+fp_bv_convt::is_inf(smt_astt x, unsigned ew, unsigned sw)
+{
+  smt_astt exp = extract(x, ew + sw - 1, sw);
+  smt_astt frac = extract(x, sw - 1, 0);
+  return land(eq(exp, bv_const(power(2, ew) - 1, ew)), is_zero(frac));
+}
+
+smt_astt
+fp_bv_convt::is_normal(smt_astt x, unsigned ew, unsigned sw)
+{
+  smt_astt exp = extract(x, ew + sw - 1, sw);
+  return land(lnot(is_zero(exp)),
+              lnot(eq(exp, bv_const(power(2, ew) - 1, ew))));
+}
+
+smt_astt
+fp_bv_convt::is_zero_fp(smt_astt x)
+{
+  return is_zero(magnitude_of(x));
+}
+
+smt_astt
+fp_bv_convt::mk_lt(smt_astt a, smt_astt b, unsigned ew, unsigned sw)
+{
+  // Sign-magnitude order, save that the zeros are equal and NaNs unordered.
+  smt_astt sa = sign_of(a), sb = sign_of(b);
+  smt_astt ma = magnitude_of(a), mb = magnitude_of(b);
+  smt_astt both_zero = land(is_zero_fp(a), is_zero_fp(b));
+
+  smt_astt lt =
+    ite(sa,
+        ite(sb, pred(SMT_FUNC_BVULT, mb, ma), lnot(both_zero)),
+        ite(sb, ctx->mk_smt_bool(false), pred(SMT_FUNC_BVULT, ma, mb)));
+
+  smt_astt ordered = lnot(lor(is_nan(a, ew, sw), is_nan(b, ew, sw)));
+  return land(ordered, lt);
+}
+
+smt_astt
+fp_bv_convt::mk_eq(smt_astt a, smt_astt b, unsigned ew, unsigned sw)
+{
+  smt_astt both_zero = land(is_zero_fp(a), is_zero_fp(b));
+  smt_astt ordered = lnot(lor(is_nan(a, ew, sw), is_nan(b, ew, sw)));
+  return land(ordered, lor(eq(a, b), both_zero));
+}
+
+fp_bv_convt::unpackedt
+fp_bv_convt::unpack(smt_astt x, unsigned ew, unsigned sw, unsigned exp_width)
+{
+  assert(exp_width > ew);
+
+  smt_astt exp = extract(x, ew + sw - 1, sw);
+  smt_astt frac = extract(x, sw - 1, 0);
+  smt_astt exp_zero = is_zero(exp);
+  mp_integer bias = bias_of(ew);
+
+  unpackedt u;
+  u.sign = sign_of(x);
+  u.nan = is_nan(x, ew, sw);
+  u.inf = is_inf(x, ew, sw);
+  u.zero = land(exp_zero, is_zero(frac));
+
+  // Subnormals have no hidden bit, and the exponent of the smallest normal.
+  smt_astt hidden = ite(exp_zero, bv_const(0, 1), bv_const(1, 1));
+  u.frac = concat(hidden, frac);
+  u.exp =
+    ite(exp_zero, bv_const(mp_integer(1) - bias, exp_width),
+        bvop(SMT_FUNC_BVSUB, zext(exp, exp_width), bv_const(bias, exp_width)));
+  return u;
+}
+
+void
+fp_bv_convt::normalize(unpackedt &u)
+{
+  // Count leading zeros a power of two at a time, largest first.
+  unsigned int n = width(u.frac), xw = width(u.exp);
+  unsigned int d = 1;
+  while (d * 2 <= n - 1)
+    d *= 2;
+
+  for (; d >= 1 && n > 1; d /= 2) {
+    smt_astt top_zero = is_zero(extract(u.frac, n - 1, n - d));
+    u.frac =
+      ite(top_zero, bvop(SMT_FUNC_BVSHL, u.frac, bv_const(d, n)), u.frac);
+    u.exp =
+      ite(top_zero, bvop(SMT_FUNC_BVSUB, u.exp, bv_const(d, xw)), u.exp);
+  }
+}
+
+smt_astt
+fp_bv_convt::round_up(smt_astt rm, smt_astt sign, smt_astt lsb,
+                      smt_astt guard, smt_astt sticky)
+{
+  smt_astt inexact = lor(guard, sticky);
+  smt_astt to_even = land(guard, lor(lsb, sticky));
+  smt_astt down = land(sign, inexact);
+  smt_astt up = land(lnot(sign), inexact);
+
+  return ite(is_rm(rm, ieee_floatt::ROUND_TO_EVEN), to_even,
+           ite(is_rm(rm, ieee_floatt::ROUND_TO_MINUS_INF), down,
+             ite(is_rm(rm, ieee_floatt::ROUND_TO_PLUS_INF), up,
+               ctx->mk_smt_bool(false))));
+}
+
+smt_astt
+fp_bv_convt::round(unpackedt u, smt_astt rm, unsigned ew, unsigned sw)
+{
+  normalize(u);
+
+  // Keep at least a guard bit and a sticky bit below the significand.
+  unsigned int n = width(u.frac);
+  if (n < sw + 3) {
+    u.frac = concat(u.frac, bv_const(0, sw + 3 - n));
+    n = sw + 3;
+  }
+
+  unsigned int xw = width(u.exp);
+  assert(xw > ew + 1);
+  mp_integer bias = bias_of(ew);
+
+  // Results below the smallest normal exponent become subnormal: shift them
+  // down to it.
+  smt_astt min_exp = bv_const(mp_integer(1) - bias, xw);
+  smt_astt tiny = pred(SMT_FUNC_BVSLT, u.exp, min_exp);
+  smt_astt dist = bvop(SMT_FUNC_BVSUB, min_exp, u.exp);
+  smt_astt denormal = sticky_shr(u.frac, shift_distance(dist, n - 1, n));
+  smt_astt frac = ite(tiny, denormal, u.frac);
+  smt_astt exp = ite(tiny, min_exp, u.exp);
+
+  // Round to sw + 1 bits.
+  unsigned int extra = n - (sw + 1);
+  smt_astt kept = extract(frac, n - 1, extra);
+  smt_astt guard = bit(frac, extra - 1);
+  smt_astt sticky = lnot(is_zero(extract(frac, extra - 2, 0)));
+  smt_astt inc = round_up(rm, u.sign, bit(frac, extra), guard, sticky);
+
+  smt_astt one = ite(inc, bv_const(1, 1), bv_const(0, 1));
+  smt_astt sum = bvop(SMT_FUNC_BVADD, zext(kept, sw + 2), zext(one, sw + 2));
+  smt_astt carry = bit(sum, sw + 1);
+  kept = ite(carry, extract(sum, sw + 1, 1), extract(sum, sw, 0));
+  exp = ite(carry, bvop(SMT_FUNC_BVADD, exp, bv_const(1, xw)), exp);
+
+  // Overflow goes to infinity, or to the largest finite number when the
+  // rounding direction is towards zero.
+  smt_astt overflow = land(lnot(is_zero(kept)),
+                           pred(SMT_FUNC_BVSGT, exp, bv_const(bias, xw)));
+  smt_astt to_inf =
+    lor(is_rm(rm, ieee_floatt::ROUND_TO_EVEN),
+        lor(land(is_rm(rm, ieee_floatt::ROUND_TO_PLUS_INF), lnot(u.sign)),
+            land(is_rm(rm, ieee_floatt::ROUND_TO_MINUS_INF), u.sign)));
+  smt_astt inf = lor(u.inf, land(overflow, to_inf));
+  smt_astt to_max = land(overflow, lnot(to_inf));
+  kept = ite(to_max, bv_const(power(2, sw + 1) - 1, sw + 1), kept);
+  exp = ite(to_max, bv_const(bias, xw), exp);
+
+  // Pack. Without the hidden bit, the number is subnormal or zero.
+  smt_astt biased =
+    extract(bvop(SMT_FUNC_BVADD, exp, bv_const(bias, xw)), ew - 1, 0);
+  smt_astt exp_field = ite(bit(kept, sw), biased, bv_const(0, ew));
+  smt_astt sign = ite(u.sign, bv_const(1, 1), bv_const(0, 1));
+
+  smt_astt finite =
+    concat(concat(sign, exp_field), extract(kept, sw - 1, 0));
+  smt_astt infinity =
+    concat(concat(sign, bv_const(power(2, ew) - 1, ew)), bv_const(0, sw));
+  smt_astt nan = mk_smt_fpbv_nan(ew, sw);
+
+  return ite(u.nan, nan, ite(inf, infinity, finite));
+}
+
+fp_bv_convt::unpackedt
+fp_bv_convt::add_unpacked(const unpackedt &a, const unpackedt &b, smt_astt rm)
+{
+  unsigned int n = width(a.frac), xw = width(a.exp);
+  assert(width(b.frac) == n && width(b.exp) == xw);
+
+  // A zero's exponent means nothing; line it up with the other operand so
+  // that it never causes that one to be shifted.
+  smt_astt ea = ite(a.zero, b.exp, a.exp);
+  smt_astt eb = ite(b.zero, a.exp, b.exp);
+
+  smt_astt diff = bvop(SMT_FUNC_BVSUB, ea, eb);
+  smt_astt b_bigger = pred(SMT_FUNC_BVSLT, diff, bv_const(0, xw));
+  smt_astt dist = ite(b_bigger, bvop(SMT_FUNC_BVSUB, bv_const(0, xw), diff),
+                      diff);
+
+  smt_astt big = ite(b_bigger, b.frac, a.frac);
+  smt_astt small = ite(b_bigger, a.frac, b.frac);
+  smt_astt big_sign = ite(b_bigger, b.sign, a.sign);
+  smt_astt small_sign = ite(b_bigger, a.sign, b.sign);
+
+  // Three more bits at the bottom keep guard, round and sticky through the
+  // alignment shift, and one more at the top catches the carry.
+  big = concat(big, bv_const(0, 3));
+  small = concat(small, bv_const(0, 3));
+  small = sticky_shr(small, shift_distance(dist, n + 2, n + 3));
+  big = zext(big, n + 4);
+  small = zext(small, n + 4);
+
+  smt_astt subtract = lxor(a.sign, b.sign);
+  smt_astt small_greater = pred(SMT_FUNC_BVULT, big, small);
+  smt_astt frac =
+    ite(subtract,
+        ite(small_greater, bvop(SMT_FUNC_BVSUB, small, big),
+            bvop(SMT_FUNC_BVSUB, big, small)),
+        bvop(SMT_FUNC_BVADD, big, small));
+
+  unpackedt r;
+  r.frac = frac;
+  r.exp = bvop(SMT_FUNC_BVADD, ite(b_bigger, eb, ea), bv_const(1, xw));
+  r.nan = lor(lor(a.nan, b.nan), land(land(a.inf, b.inf), subtract));
+  r.inf = land(lnot(r.nan), lor(a.inf, b.inf));
+  r.zero = is_zero(frac);
+
+  // An exact zero is positive, unless both operands were negative or we are
+  // rounding downwards.
+  smt_astt zero_sign =
+    ite(is_rm(rm, ieee_floatt::ROUND_TO_MINUS_INF), lor(a.sign, b.sign),
+        land(a.sign, b.sign));
+  smt_astt sum_sign =
+    ite(land(subtract, small_greater), small_sign, big_sign);
+  r.sign = ite(r.inf, ite(a.inf, a.sign, b.sign),
+               ite(r.zero, zero_sign, sum_sign));
+  return r;
+}
+
+smt_astt
+fp_bv_convt::mk_add(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                    unsigned sw, bool subtract)
+{
+  // Unnormalized operands are fine here: a subnormal has the least exponent
+  // there is, so it is only ever the bigger operand when the exponents match.
+  unsigned int xw = exp_width_for(ew, sw + 5);
+  unpackedt ua = unpack(a, ew, sw, xw);
+  unpackedt ub = unpack(b, ew, sw, xw);
+  if (subtract)
+    ub.sign = lnot(ub.sign);
+
+  return round(add_unpacked(ua, ub, rm), rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_mul(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                    unsigned sw)
+{
+  unsigned int n = sw + 1;
+  unsigned int xw = exp_width_for(ew, 2 * n);
+  unpackedt ua = unpack(a, ew, sw, xw);
+  unpackedt ub = unpack(b, ew, sw, xw);
+
+  // The product of the significands is exact, with its top bit worth twice
+  // the product of the operands' top bits.
+  unpackedt r;
+  r.frac = bvop(SMT_FUNC_BVMUL, zext(ua.frac, 2 * n), zext(ub.frac, 2 * n));
+  r.exp = bvop(SMT_FUNC_BVADD, bvop(SMT_FUNC_BVADD, ua.exp, ub.exp),
+               bv_const(1, xw));
+  r.sign = lxor(ua.sign, ub.sign);
+  r.nan = lor(lor(ua.nan, ub.nan),
+              lor(land(ua.inf, ub.zero), land(ua.zero, ub.inf)));
+  r.inf = land(lnot(r.nan), lor(ua.inf, ub.inf));
+  r.zero = lor(ua.zero, ub.zero);
+
+  return round(r, rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_div(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                    unsigned sw)
+{
+  // With both significands normalized, padding the dividend by sw + 3 bits
+  // leaves the quotient with at least that many significant bits: the result,
+  // a guard bit and one more. The remainder supplies the sticky bit.
+  unsigned int n = sw + 1, pad = sw + 3, dw = n + pad;
+  unsigned int xw = exp_width_for(ew, dw + 1);
+  unpackedt ua = unpack(a, ew, sw, xw);
+  unpackedt ub = unpack(b, ew, sw, xw);
+  normalize(ua);
+  normalize(ub);
+
+  smt_astt num = concat(ua.frac, bv_const(0, pad));
+  smt_astt den = zext(ub.frac, dw);
+  smt_astt quot = bvop(SMT_FUNC_BVUDIV, num, den);
+  smt_astt rem = bvop(SMT_FUNC_BVUMOD, num, den);
+  smt_astt sticky = ite(is_zero(rem), bv_const(0, 1), bv_const(1, 1));
+
+  unpackedt r;
+  r.sign = lxor(ua.sign, ub.sign);
+  r.nan = lor(lor(ua.nan, ub.nan),
+              lor(land(ua.zero, ub.zero), land(ua.inf, ub.inf)));
+  r.inf = land(lnot(r.nan), lor(ua.inf, ub.zero));
+  r.zero = lor(ua.zero, ub.inf);
+
+  // Dividing by infinity gives zero.
+  r.frac = ite(ub.inf, bv_const(0, dw + 1), concat(quot, sticky));
+  r.exp = bvop(SMT_FUNC_BVADD, bvop(SMT_FUNC_BVSUB, ua.exp, ub.exp),
+               bv_const(sw, xw));
+
+  return round(r, rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_fma(smt_astt a, smt_astt b, smt_astt c, smt_astt rm,
+                    unsigned ew, unsigned sw)
+{
+  // The exact product, added to c with a single rounding. The addition wants
+  // normalized operands, as either may be the bigger one now.
+  unsigned int n = sw + 1, pw = 2 * n;
+  unsigned int xw = exp_width_for(ew, pw + 4);
+  unpackedt ua = unpack(a, ew, sw, xw);
+  unpackedt ub = unpack(b, ew, sw, xw);
+  unpackedt uc = unpack(c, ew, sw, xw);
+
+  unpackedt p;
+  p.frac = bvop(SMT_FUNC_BVMUL, zext(ua.frac, pw), zext(ub.frac, pw));
+  p.exp = bvop(SMT_FUNC_BVADD, bvop(SMT_FUNC_BVADD, ua.exp, ub.exp),
+               bv_const(1, xw));
+  p.sign = lxor(ua.sign, ub.sign);
+  p.nan = lor(lor(ua.nan, ub.nan),
+              lor(land(ua.inf, ub.zero), land(ua.zero, ub.inf)));
+  p.inf = lor(ua.inf, ub.inf);
+  p.zero = lor(ua.zero, ub.zero);
+  normalize(p);
+
+  normalize(uc);
+  uc.frac = concat(uc.frac, bv_const(0, pw - n));
+
+  return round(add_unpacked(p, uc, rm), rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_sqrt(smt_astt a, smt_astt rm, unsigned ew, unsigned sw)
+{
+  // Scale the normalized significand up by sw + 4 or sw + 5 bits, whichever
+  // leaves an even exponent, and take the integer square root of that. The
+  // root then has sw + 3 significant bits, and the remainder gives the
+  // sticky bit. Ties cannot happen.
+  unsigned int n = sw + 1, rw = 2 * sw + 6, hw = rw / 2;
+  unsigned int xw = exp_width_for(ew, rw + 1);
+  unpackedt ua = unpack(a, ew, sw, xw);
+  normalize(ua);
+
+  smt_astt odd = bit(ua.exp, 0);
+  smt_astt m = zext(ua.frac, rw);
+  smt_astt num =
+    ite(odd, bvop(SMT_FUNC_BVSHL, m, bv_const(n + 4, rw)),
+        bvop(SMT_FUNC_BVSHL, m, bv_const(n + 3, rw)));
+
+  // Digit by digit, two bits of the radicand per bit of the root.
+  smt_astt res = bv_const(0, rw);
+  smt_astt one = bv_const(1, rw);
+  for (int i = rw - 2; i >= 0; i -= 2) {
+    smt_astt b = bv_const(power(2, i), rw);
+    smt_astt trial = bvop(SMT_FUNC_BVADD, res, b);
+    smt_astt fits = lnot(pred(SMT_FUNC_BVULT, num, trial));
+    smt_astt half = bvop(SMT_FUNC_BVLSHR, res, one);
+    num = ite(fits, bvop(SMT_FUNC_BVSUB, num, trial), num);
+    res = ite(fits, bvop(SMT_FUNC_BVADD, half, b), half);
+  }
+
+  smt_astt sticky = ite(is_zero(num), bv_const(0, 1), bv_const(1, 1));
+
+  unpackedt r;
+  r.frac = concat(extract(res, hw - 1, 0), sticky);
+  r.exp = bvop(SMT_FUNC_BVASHR, ua.exp, bv_const(1, xw));
+  r.sign = ua.sign;
+  r.nan = lor(ua.nan, land(ua.sign, lnot(ua.zero)));
+  r.inf = land(lnot(r.nan), ua.inf);
+  r.zero = ua.zero;
+
+  return round(r, rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_from_float(smt_astt a, smt_astt rm, unsigned from_ew,
+                           unsigned from_sw, unsigned ew, unsigned sw)
+{
+  unsigned int xw =
+    exp_width_for(std::max(from_ew, ew), std::max(from_sw, sw) + 4);
+  unpackedt u = unpack(a, from_ew, from_sw, xw);
+  return round(u, rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_from_int(smt_astt a, bool is_signed, smt_astt rm,
+                         unsigned ew, unsigned sw)
+{
+  unsigned int w = width(a);
+  unsigned int xw = exp_width_for(ew, std::max(w, sw + 3));
+
+  unpackedt u;
+  if (is_signed) {
+    u.sign = bit(a, w - 1);
+    u.frac = ite(u.sign, bvop(SMT_FUNC_BVSUB, bv_const(0, w), a), a);
+  } else {
+    u.sign = ctx->mk_smt_bool(false);
+    u.frac = a;
+  }
+
+  u.exp = bv_const(w - 1, xw);
+  u.nan = ctx->mk_smt_bool(false);
+  u.inf = ctx->mk_smt_bool(false);
+  u.zero = is_zero(u.frac);
+  return round(u, rm, ew, sw);
+}
+
+smt_astt
+fp_bv_convt::mk_to_int(smt_astt a, bool is_signed, unsigned int w,
+                       unsigned ew, unsigned sw)
+{
+  // Truncate towards zero: shift the significand so that its bottom bit is
+  // worth one, throwing away whatever falls off. Out of range values, NaNs
+  // and infinities give an unspecified result, as they do in C.
+  unsigned int n = sw + 1, tw = n + w;
+  unsigned int xw = exp_width_for(ew, tw);
+  unpackedt u = unpack(a, ew, sw, xw);
+
+  smt_astt shift = bvop(SMT_FUNC_BVSUB, u.exp, bv_const(sw, xw));
+  smt_astt left = lnot(pred(SMT_FUNC_BVSLT, shift, bv_const(0, xw)));
+  smt_astt right = bvop(SMT_FUNC_BVSUB, bv_const(0, xw), shift);
+
+  smt_astt t = zext(u.frac, tw);
+  smt_astt mag =
+    ite(left, bvop(SMT_FUNC_BVSHL, t, shift_distance(shift, tw - 1, tw)),
+        bvop(SMT_FUNC_BVLSHR, t, shift_distance(right, tw - 1, tw)));
+  mag = extract(mag, w - 1, 0);
+
+  smt_sortt s = ctx->mk_sort(is_signed ? SMT_SORT_SBV : SMT_SORT_UBV, w);
+  return ctx->mk_func_app(s, SMT_FUNC_ITE, u.sign,
+                          bvop(SMT_FUNC_BVSUB, bv_const(0, w), mag), mag);
+}
+
+smt_astt
+fp_bv_convt::mk_to_integral(smt_astt a, smt_astt rm, unsigned ew, unsigned sw)
+{
+  // Shift the fractional part out into a guard and a sticky bit, round the
+  // integer that is left, and convert that back (exactly) to a float. Numbers
+  // whose bottom bit is worth one or more are already integral.
+  unsigned int n = sw + 1;
+  unsigned int xw = exp_width_for(ew, n + 3);
+  unpackedt u = unpack(a, ew, sw, xw);
+
+  smt_astt dist = bvop(SMT_FUNC_BVSUB, bv_const(sw, xw), u.exp);
+  smt_astt integral = pred(SMT_FUNC_BVSLT, dist, bv_const(1, xw));
+
+  smt_astt t = concat(u.frac, bv_const(0, 2));
+  t = sticky_shr(t, shift_distance(dist, n + 1, n + 2));
+
+  smt_astt inc = round_up(rm, u.sign, bit(t, 2), bit(t, 1), bit(t, 0));
+  smt_astt one = ite(inc, bv_const(1, 1), bv_const(0, 1));
+
+  unpackedt r;
+  r.frac = bvop(SMT_FUNC_BVADD, zext(extract(t, n + 1, 2), n + 1),
+                zext(one, n + 1));
+  r.exp = bv_const(n, xw);
+  r.sign = u.sign;
+  r.nan = ctx->mk_smt_bool(false);
+  r.inf = ctx->mk_smt_bool(false);
+  r.zero = is_zero(r.frac);
+
+  smt_astt keep = lor(lor(u.nan, u.inf), integral);
+  return ite(keep, a, round(r, rm, ew, sw));
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv(const ieee_floatt &thereal)
+{
+  return bv_const(thereal.pack(), thereal.spec.width());
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_nan(unsigned ew, unsigned sw)
+{
+  ieee_float_spect spec(sw, ew);
+  return bv_const(ieee_floatt::NaN(spec).pack(), spec.width());
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_inf(bool sgn, unsigned ew, unsigned sw)
+{
+  ieee_float_spect spec(sw, ew);
+  ieee_floatt inf = sgn ? ieee_floatt::minus_infinity(spec)
+                        : ieee_floatt::plus_infinity(spec);
+  return bv_const(inf.pack(), spec.width());
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_rm(ieee_floatt::rounding_modet rm)
+{
+  return bv_const(rm, 2);
+}
+
+smt_astt fp_bv_convt::mk_smt_typecast_from_fpbv(const typecast2t &cast)
+{
+  const floatbv_type2t &from = to_floatbv_type(cast.from->type);
+  smt_astt a = ctx->convert_ast(cast.from);
+
+  // Conversion from float to integers always truncates
+  if (is_unsignedbv_type(cast.type) || is_signedbv_type(cast.type))
+    return mk_to_int(a, is_signedbv_type(cast.type), cast.type->get_width(),
+                     from.exponent, from.fraction);
+
+  if (is_floatbv_type(cast.type)) {
+    const floatbv_type2t &to = to_floatbv_type(cast.type);
+    smt_astt rm = ctx->convert_rounding_mode(cast.rounding_mode);
+    return mk_from_float(a, rm, from.exponent, from.fraction, to.exponent,
+                         to.fraction);
+  }
+
+  std::cerr << "Unexpected typecast from floating-point in fp2bv\n";
+  abort();
+}
+
+smt_astt fp_bv_convt::mk_smt_typecast_to_fpbv(const typecast2t &cast)
+{
+  const floatbv_type2t &to = to_floatbv_type(cast.type);
+  smt_astt from = ctx->convert_ast(cast.from);
+
+  if (is_bool_type(cast.from)) {
+    smt_astt one = ctx->convert_ast(gen_one(cast.type));
+    smt_astt zero = ctx->convert_ast(gen_zero(cast.type));
+    return ite(from, one, zero);
+  }
+
+  smt_astt rm = ctx->convert_rounding_mode(cast.rounding_mode);
+
+  if (is_unsignedbv_type(cast.from) || is_signedbv_type(cast.from))
+    return mk_from_int(from, is_signedbv_type(cast.from), rm, to.exponent,
+                       to.fraction);
+
+  if (is_floatbv_type(cast.from)) {
+    const floatbv_type2t &f = to_floatbv_type(cast.from->type);
+    return mk_from_float(from, rm, f.exponent, f.fraction, to.exponent,
+                         to.fraction);
+  }
+
+  std::cerr << "Unexpected typecast to floating-point in fp2bv\n";
+  abort();
+}
+
+smt_astt fp_bv_convt::mk_smt_nearbyint_from_float(const nearbyint2t &expr)
+{
+  const floatbv_type2t &t = to_floatbv_type(expr.type);
+  smt_astt rm = ctx->convert_rounding_mode(expr.rounding_mode);
+  smt_astt from = ctx->convert_ast(expr.from);
+  return mk_to_integral(from, rm, t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_arith_ops(const expr2tc &expr)
+{
+  const floatbv_type2t &t = to_floatbv_type(expr->type);
+  smt_astt rm = ctx->convert_rounding_mode(*expr->get_sub_expr(0));
+  smt_astt s1 = ctx->convert_ast(*expr->get_sub_expr(1));
+
+  if (is_ieee_sqrt2t(expr))
+    return mk_sqrt(s1, rm, t.exponent, t.fraction);
+
+  smt_astt s2 = ctx->convert_ast(*expr->get_sub_expr(2));
+
+  switch (expr->expr_id) {
+  case expr2t::ieee_add_id:
+    return mk_add(s1, s2, rm, t.exponent, t.fraction, false);
+  case expr2t::ieee_sub_id:
+    return mk_add(s1, s2, rm, t.exponent, t.fraction, true);
+  case expr2t::ieee_mul_id:
+    return mk_mul(s1, s2, rm, t.exponent, t.fraction);
+  case expr2t::ieee_div_id:
+    return mk_div(s1, s2, rm, t.exponent, t.fraction);
+  default:
+    break;
+  }
+
+  abort();
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_fma(const expr2tc &expr)
+{
+  const ieee_fma2t &fma = to_ieee_fma2t(expr);
+  const floatbv_type2t &t = to_floatbv_type(fma.type);
+
+  smt_astt rm = ctx->convert_rounding_mode(fma.rounding_mode);
+  smt_astt v1 = ctx->convert_ast(fma.value_1);
+  smt_astt v2 = ctx->convert_ast(fma.value_2);
+  smt_astt v3 = ctx->convert_ast(fma.value_3);
+  return mk_fma(v1, v2, v3, rm, t.exponent, t.fraction);
+}
+
+smt_sortt fp_bv_convt::convert_fpbv_sort(unsigned ew, unsigned sw)
+{
+  return bv_sort(ew + sw + 1);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_neg(const expr2tc &op)
+{
+  // Only the sign changes, NaN or not.
+  smt_astt a = ctx->convert_ast(op);
+  smt_astt sign = extract(a, width(a) - 1, width(a) - 1);
+  return concat(ctx->mk_func_app(sign->sort, SMT_FUNC_BVNOT, sign),
+                magnitude_of(a));
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_abs(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return concat(bv_const(0, 1), magnitude_of(a));
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_is_nan(const expr2tc &op)
+{
+  const floatbv_type2t &t = to_floatbv_type(op->type);
+  return is_nan(ctx->convert_ast(op), t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_is_inf(const expr2tc &op)
+{
+  const floatbv_type2t &t = to_floatbv_type(op->type);
+  return is_inf(ctx->convert_ast(op), t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_is_normal(const expr2tc &op)
+{
+  const floatbv_type2t &t = to_floatbv_type(op->type);
+  return is_normal(ctx->convert_ast(op), t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_is_neg(const expr2tc &op)
+{
+  const floatbv_type2t &t = to_floatbv_type(op->type);
+  smt_astt a = ctx->convert_ast(op);
+  return land(sign_of(a), lnot(is_nan(a, t.exponent, t.fraction)));
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_eq(const expr2tc &lhs, const expr2tc &rhs)
+{
+  const floatbv_type2t &t = to_floatbv_type(lhs->type);
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return mk_eq(l, r, t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_lt(const expr2tc &lhs, const expr2tc &rhs)
+{
+  const floatbv_type2t &t = to_floatbv_type(lhs->type);
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return mk_lt(l, r, t.exponent, t.fraction);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_lte(const expr2tc &lhs, const expr2tc &rhs)
+{
+  const floatbv_type2t &t = to_floatbv_type(lhs->type);
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return lor(mk_lt(l, r, t.exponent, t.fraction),
+             mk_eq(l, r, t.exponent, t.fraction));
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_gt(const expr2tc &lhs, const expr2tc &rhs)
+{
+  return mk_smt_fpbv_lt(rhs, lhs);
+}
+
+smt_astt fp_bv_convt::mk_smt_fpbv_gte(const expr2tc &lhs, const expr2tc &rhs)
+{
+  return mk_smt_fpbv_lte(rhs, lhs);
+}
+
+smt_astt fp_bv_convt::mk_smt_bitcast_to_fpbv(const bitcast2t &cast)
+{
+  // Floats are their bits already.
+  return ctx->convert_ast(cast.from);
+}
+
+smt_astt fp_bv_convt::mk_smt_bitcast_from_fpbv(const bitcast2t &cast)
+{
+  return ctx->convert_ast(cast.from);
+}
+
+expr2tc fp_bv_convt::get_fpbv(const type2tc &t, smt_astt a)
+{
+  const floatbv_type2t &fbv = to_floatbv_type(t);
+  ieee_float_spect spec(fbv.fraction, fbv.exponent);
+
+  expr2tc bits = ctx->get_bv(get_uint_type(spec.width()), a);
+  ieee_floatt number(spec);
+  number.unpack(to_constant_int2t(bits).value);
+  return constant_floatbv2tc(number);
+}
@@ -0,0 +1,132 @@
+#ifndef _ESBMC_SOLVERS_SMT_FP_BV_CONV_H_
+#define _ESBMC_SOLVERS_SMT_FP_BV_CONV_H_
+
+// Lowers IEEE-754 floating-point to bitvectors, so that --floatbv can be run
+// on a solver without a floating-point theory of its own, or on one whose
+// theory is slow. Selected with --fp2bv.
+//
+// A float is held as a bitvector of its packed IEEE format: sign, biased
+// exponent, fraction. A rounding mode is a two bit vector holding the value
+// of ieee_floatt::rounding_modet. Operations unpack their operands into sign,
+// exponent, significand and special-case flags, compute on those with extra
+// significand bits where a result is inexact, and then round and pack the
+// result once. The approach follows the CBMC float_utils bit-blaster, but is
+// written against the word-level operations of smt_convt.
+
+#include <solvers/smt/fp_conv.h>
+
+class fp_bv_convt : public fp_convt
+{
+public:
+  fp_bv_convt(smt_convt *_ctx);
+  ~fp_bv_convt() override = default;
+
+  smt_astt mk_smt_fpbv(const ieee_floatt &thereal) override;
+  smt_astt mk_smt_fpbv_nan(unsigned ew, unsigned sw) override;
+  smt_astt mk_smt_fpbv_inf(bool sgn, unsigned ew, unsigned sw) override;
+  smt_astt mk_smt_fpbv_rm(ieee_floatt::rounding_modet rm) override;
+  smt_astt mk_smt_typecast_from_fpbv(const typecast2t &cast) override;
+  smt_astt mk_smt_typecast_to_fpbv(const typecast2t &cast) override;
+  smt_astt mk_smt_nearbyint_from_float(const nearbyint2t &expr) override;
+  smt_astt mk_smt_fpbv_arith_ops(const expr2tc &expr) override;
+  smt_astt mk_smt_fpbv_fma(const expr2tc &expr) override;
+  smt_sortt convert_fpbv_sort(unsigned ew, unsigned sw) override;
+  smt_astt mk_smt_fpbv_neg(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_abs(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_is_nan(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_is_inf(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_is_normal(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_is_neg(const expr2tc &op) override;
+  smt_astt mk_smt_fpbv_eq(const expr2tc &lhs, const expr2tc &rhs) override;
+  smt_astt mk_smt_fpbv_lt(const expr2tc &lhs, const expr2tc &rhs) override;
+  smt_astt mk_smt_fpbv_lte(const expr2tc &lhs, const expr2tc &rhs) override;
+  smt_astt mk_smt_fpbv_gt(const expr2tc &lhs, const expr2tc &rhs) override;
+  smt_astt mk_smt_fpbv_gte(const expr2tc &lhs, const expr2tc &rhs) override;
+  smt_astt mk_smt_bitcast_to_fpbv(const bitcast2t &cast) override;
+  smt_astt mk_smt_bitcast_from_fpbv(const bitcast2t &cast) override;
+  expr2tc get_fpbv(const type2tc &t, smt_astt a) override;
+
+protected:
+  /** A float taken apart. The value is frac * 2^(exp - (width(frac) - 1)),
+   *  that is, exp is the weight of the top bit of frac, which need not be
+   *  set. exp is signed, and as wide as the operation needs. */
+  struct unpackedt
+  {
+    smt_astt sign;
+    smt_astt nan;
+    smt_astt inf;
+    smt_astt zero;
+    smt_astt exp;
+    smt_astt frac;
+  };
+
+  // Word-level helpers. Every bitvector is made with an unsigned sort;
+  // signedness is in the choice of operation.
+  smt_sortt bv_sort(unsigned int width);
+  smt_astt bv_const(const mp_integer &val, unsigned int width);
+  static unsigned int width(smt_astt a) { return a->sort->get_data_width(); }
+  smt_astt extract(smt_astt a, unsigned int high, unsigned int low);
+  smt_astt concat(smt_astt hi, smt_astt lo);
+  smt_astt zext(smt_astt a, unsigned int width);
+  smt_astt bvop(smt_func_kind k, smt_astt a, smt_astt b);
+  smt_astt pred(smt_func_kind k, smt_astt a, smt_astt b);
+  smt_astt ite(smt_astt cond, smt_astt t, smt_astt f);
+  smt_astt lnot(smt_astt a);
+  smt_astt land(smt_astt a, smt_astt b);
+  smt_astt lor(smt_astt a, smt_astt b);
+  smt_astt lxor(smt_astt a, smt_astt b);
+  smt_astt eq(smt_astt a, smt_astt b);
+  smt_astt bit(smt_astt a, unsigned int idx);
+  smt_astt is_zero(smt_astt a);
+  smt_astt is_rm(smt_astt rm, ieee_floatt::rounding_modet mode);
+  /** Clamp the nonnegative, signed dist to at most limit, and fit it to
+   *  width bits, to be used as a shift distance. */
+  smt_astt shift_distance(smt_astt dist, unsigned int limit,
+                          unsigned int width);
+  /** Shift right by dist, ORing everything shifted out into the bottom bit. */
+  smt_astt sticky_shr(smt_astt a, smt_astt dist);
+
+  // Classification of packed floats.
+  smt_astt sign_of(smt_astt x);
+  smt_astt magnitude_of(smt_astt x);
+  smt_astt is_nan(smt_astt x, unsigned ew, unsigned sw);
+  smt_astt is_inf(smt_astt x, unsigned ew, unsigned sw);
+  smt_astt is_normal(smt_astt x, unsigned ew, unsigned sw);
+  smt_astt is_zero_fp(smt_astt x);
+  smt_astt mk_lt(smt_astt a, smt_astt b, unsigned ew, unsigned sw);
+  smt_astt mk_eq(smt_astt a, smt_astt b, unsigned ew, unsigned sw);
+
+  /** Whether rounding in direction rm moves a magnitude away from zero,
+   *  given its least significant kept bit, the bit below, and whether
+   *  anything below that is set. */
+  smt_astt round_up(smt_astt rm, smt_astt sign, smt_astt lsb, smt_astt guard,
+                    smt_astt sticky);
+  unpackedt unpack(smt_astt x, unsigned ew, unsigned sw, unsigned exp_width);
+  /** Shift the leading zeros out of frac, adjusting exp to match. */
+  void normalize(unpackedt &u);
+  /** Round u to the format given by ew and sw, and pack it. */
+  smt_astt round(unpackedt u, smt_astt rm, unsigned ew, unsigned sw);
+  /** a + b, with enough bits kept for round to be exact. Both significands
+   *  must be as wide, and normalized unless their exponents can only differ
+   *  when the one with the greater exponent is normal. */
+  unpackedt add_unpacked(const unpackedt &a, const unpackedt &b, smt_astt rm);
+
+  smt_astt mk_add(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                  unsigned sw, bool subtract);
+  smt_astt mk_mul(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                  unsigned sw);
+  smt_astt mk_div(smt_astt a, smt_astt b, smt_astt rm, unsigned ew,
+                  unsigned sw);
+  smt_astt mk_fma(smt_astt a, smt_astt b, smt_astt c, smt_astt rm,
+                  unsigned ew, unsigned sw);
+  smt_astt mk_sqrt(smt_astt a, smt_astt rm, unsigned ew, unsigned sw);
+  smt_astt mk_from_float(smt_astt a, smt_astt rm, unsigned from_ew,
+                         unsigned from_sw, unsigned ew, unsigned sw);
+  smt_astt mk_from_int(smt_astt a, bool is_signed, smt_astt rm, unsigned ew,
+                       unsigned sw);
+  smt_astt mk_to_int(smt_astt a, bool is_signed, unsigned int width,
+                     unsigned ew, unsigned sw);
+  smt_astt mk_to_integral(smt_astt a, smt_astt rm, unsigned ew, unsigned sw);
+};
+
+#endif /* _ESBMC_SOLVERS_SMT_FP_BV_CONV_H_ */
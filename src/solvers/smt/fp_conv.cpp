@@ -92,6 +92,99 @@ smt_sortt fp_convt::mk_fpbv_sort(const unsigned ew, const unsigned sw)
   abort();
 }
 
+// The rest hand the operation to the solver's floating-point theory, through
+// the function kinds that smt_convt has for it.
+
+smt_sortt fp_convt::convert_fpbv_sort(unsigned ew, unsigned sw)
+{
+  return ctx->mk_sort(SMT_SORT_FLOATBV, ew, sw);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_neg(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(a->sort, SMT_FUNC_NEG, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_abs(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(a->sort, SMT_FUNC_FABS, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_is_nan(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_ISNAN, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_is_inf(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_ISINF, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_is_normal(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_ISNORMAL, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_is_neg(const expr2tc &op)
+{
+  smt_astt a = ctx->convert_ast(op);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_ISNEG, a);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_eq(const expr2tc &lhs, const expr2tc &rhs)
+{
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_IEEE_EQ, l, r);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_lt(const expr2tc &lhs, const expr2tc &rhs)
+{
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_LT, l, r);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_lte(const expr2tc &lhs, const expr2tc &rhs)
+{
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_LTE, l, r);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_gt(const expr2tc &lhs, const expr2tc &rhs)
+{
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_GT, l, r);
+}
+
+smt_astt fp_convt::mk_smt_fpbv_gte(const expr2tc &lhs, const expr2tc &rhs)
+{
+  smt_astt l = ctx->convert_ast(lhs);
+  smt_astt r = ctx->convert_ast(rhs);
+  return ctx->mk_func_app(ctx->boolean_sort, SMT_FUNC_GTE, l, r);
+}
+
+smt_astt fp_convt::mk_smt_bitcast_to_fpbv(const bitcast2t &cast)
+{
+  smt_astt from = ctx->convert_ast(cast.from);
+  smt_sortt s = ctx->convert_sort(cast.type);
+  return ctx->mk_func_app(s, SMT_FUNC_BV2FLOAT, from);
+}
+
+smt_astt fp_convt::mk_smt_bitcast_from_fpbv(const bitcast2t &cast)
+{
+  smt_astt from = ctx->convert_ast(cast.from);
+  smt_sortt s = ctx->convert_sort(cast.type);
+  return ctx->mk_func_app(s, SMT_FUNC_FLOAT2BV, from);
+}
+
 expr2tc fp_convt::get_fpbv(const type2tc &t, smt_astt a)
 {
   std::cerr << "Chosen solver doesn't support floating-point numbers (cex)\n";
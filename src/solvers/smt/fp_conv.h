@@ -71,6 +71,45 @@ public:
    *  @return The floating-point representation of the type, wrapped in an smt_sort. */
   virtual smt_sortt mk_fpbv_sort(const unsigned ew, const unsigned sw);
 
+  /** Create the sort that values of a floating-point type are converted to.
+   *  By default this is the solver's own floating-point sort.
+   *  @param ew Exponent width, in bits.
+   *  @param sw Significand width, in bits, not counting the hidden bit.
+   *  @return The sort to represent floats of this format with. */
+  virtual smt_sortt convert_fpbv_sort(unsigned ew, unsigned sw);
+
+  /** Negate a floating point, and take its absolute value.
+   *  @param op the floating point operand
+   *  @return The newly created smt_ast. */
+  virtual smt_astt mk_smt_fpbv_neg(const expr2tc &op);
+  virtual smt_astt mk_smt_fpbv_abs(const expr2tc &op);
+
+  /** Classify a floating point. is_neg is false for NaNs.
+   *  @param op the floating point operand
+   *  @return The newly created boolean smt_ast. */
+  virtual smt_astt mk_smt_fpbv_is_nan(const expr2tc &op);
+  virtual smt_astt mk_smt_fpbv_is_inf(const expr2tc &op);
+  virtual smt_astt mk_smt_fpbv_is_normal(const expr2tc &op);
+  virtual smt_astt mk_smt_fpbv_is_neg(const expr2tc &op);
+
+  /** Compare two floating points, as IEEE 754 does: NaNs are unordered, and
+   *  the two zeros are equal.
+   *  @param lhs the left hand side of the comparison
+   *  @param rhs the right hand side of the comparison
+   *  @return The newly created boolean smt_ast. */
+  virtual smt_astt mk_smt_fpbv_eq(const expr2tc &lhs, const expr2tc &rhs);
+  virtual smt_astt mk_smt_fpbv_lt(const expr2tc &lhs, const expr2tc &rhs);
+  virtual smt_astt mk_smt_fpbv_lte(const expr2tc &lhs, const expr2tc &rhs);
+  virtual smt_astt mk_smt_fpbv_gt(const expr2tc &lhs, const expr2tc &rhs);
+  virtual smt_astt mk_smt_fpbv_gte(const expr2tc &lhs, const expr2tc &rhs);
+
+  /** Reinterpret the bits of a bitvector as a floating point, or the other
+   *  way around.
+   *  @param cast the bitcast expression
+   *  @return The newly created cast smt_ast. */
+  virtual smt_astt mk_smt_bitcast_to_fpbv(const bitcast2t &cast);
+  virtual smt_astt mk_smt_bitcast_from_fpbv(const bitcast2t &cast);
+
   /** Extract the assignment to a floating-point from the SMT solvers model.
    *  @param t The AST type
    *  @param a The AST whos value we wish to know.
@@ -45,6 +45,14 @@ public:
 
   virtual void add_array_constraints_for_solving() = 0;
 
+  /** Check the model the solver has just produced against any array axioms
+   *  that were left out of the formula, to be added on demand, and assert
+   *  the ones that it breaks. By default every axiom is encoded up front, and
+   *  there's nothing to do.
+   *  @return True if anything was asserted, and the formula must be solved
+   *          again. */
+  virtual bool refine_array_model() { return false; }
+
   virtual void push_array_ctx() = 0;
   virtual void pop_array_ctx() = 0;
 
@@ -143,10 +143,14 @@ void
 smt_convt::delete_all_asts()
 {
 
-  // Erase all the remaining asts in the live ast vector.
+  // Destroy all the remaining asts in the live ast vector, then give back
+  // their memory in one go.
   for (smt_ast *ast : live_asts)
-    delete ast;
+    ast->~smt_ast();
   live_asts.clear();
+  live_asts_sizes.clear();
+  ast_region.release_all();
+  ast_region_marks.clear();
 }
 
 void
@@ -194,6 +198,9 @@ smt_convt::push_ctx()
   renumber_map.push_back(renumber_map.back());
 
   live_asts_sizes.push_back(live_asts.size());
+  ast_region_marks.push_back(ast_region.mark());
+  smt_cache.push();
+  func_app_cache.push();
 
   ctx_level++;
 }
@@ -204,8 +211,8 @@ smt_convt::pop_ctx()
 
   // Erase everything in caches added in the current context level. Everything
   // before the push is going to disappear.
-  smt_cachet::nth_index<1>::type &cache_numindex = smt_cache.get<1>();
-  cache_numindex.erase(ctx_level);
+  smt_cache.pop();
+  func_app_cache.pop();
   pointer_logic.pop_back();
   addr_space_sym_num.pop_back();
   addr_space_data.pop_back();
@@ -213,19 +220,50 @@ smt_convt::pop_ctx()
 
   ctx_level--;
 
-  // Go through all the asts created since the last push and delete them.
+  // Go through all the asts created since the last push and destroy them.
 
   for (unsigned int idx = live_asts_sizes.back(); idx < live_asts.size(); idx++)
-    delete live_asts[idx];
+    live_asts[idx]->~smt_ast();
 
   // And reset the storage back to that point.
   live_asts.resize(live_asts_sizes.back());
   live_asts_sizes.pop_back();
+  ast_region.release(ast_region_marks.back());
+  ast_region_marks.pop_back();
 
   array_api->pop_array_ctx();
   tuple_api->pop_tuple_ctx();
 }
 
+smt_astt
+smt_convt::mk_func_app(smt_sortt s, smt_func_kind k, smt_astt const *args,
+                       unsigned int numargs)
+{
+  // Tuple ASTs get updated in place by the tuple flattener, so mustn't be
+  // shared between applications that happen to look the same.
+  if (numargs > 4 || s->id == SMT_SORT_STRUCT || s->id == SMT_SORT_UNION)
+    return mk_func_app_impl(s, k, args, numargs);
+
+  func_app_keyt key;
+  key.kind = k;
+  key.sort_kind = s->id;
+  key.width = s->get_data_width();
+  key.secondary_width =
+    (s->id == SMT_SORT_FLOATBV) ? s->get_significand_width() : 0;
+  key.array_sort = (s->id == SMT_SORT_ARRAY) ? s : nullptr;
+  key.numargs = numargs;
+  for (unsigned int i = 0; i < 4; i++)
+    key.args[i] = (i < numargs) ? args[i] : nullptr;
+
+  const smt_astt *cached = func_app_cache.find(key);
+  if (cached != nullptr)
+    return *cached;
+
+  smt_astt a = mk_func_app_impl(s, k, args, numargs);
+  func_app_cache.insert(key, a);
+  return a;
+}
+
 smt_astt
 smt_convt::make_disjunct(const ast_vec &v)
 {
@@ -322,8 +360,7 @@ smt_convt::convert_assign(const expr2tc &expr)
   // IMPORTANT: the cache is now a fundemental part of how some flatteners work,
   // in that one can chose to create a set of expressions and their ASTs, then
   // store them in the cache, rather than have a more sophisticated conversion.
-  smt_cache_entryt e = { eq.side_1, side1, ctx_level };
-  smt_cache.insert(e);
+  smt_cache.insert(eq.side_1, side1);
 }
 
 smt_astt
@@ -371,8 +408,7 @@ smt_convt::convert_ast(
     abort();
   }
 
-  struct smt_cache_entryt entry = { expr, a, ctx_level };
-  smt_cache.insert(entry);
+  smt_cache.insert(expr, a);
 
   return a;
 }
@@ -386,9 +422,9 @@ smt_convt::convert_ast(const expr2tc &expr)
   smt_sortt sort;
   smt_astt a;
 
-  smt_cachet::const_iterator cache_result = smt_cache.find(expr);
-  if (cache_result != smt_cache.end())
-    return (cache_result->ast);
+  const smt_astt *cache_result = smt_cache.find(expr);
+  if (cache_result != nullptr)
+    return *cache_result;
 
   unsigned int i = 0;
 
@@ -598,7 +634,7 @@ smt_convt::convert_ast(const expr2tc &expr)
   {
     assert(is_floatbv_type(expr));
     assert(expr->get_num_sub_exprs() == 2);
-    a = fp_api->mk_smt_fpbv_fma(expr);
+    a = fp_api->mk_smt_fpbv_arith_ops(expr);
     break;
   }
   case expr2t::modulus_id:
@@ -887,7 +923,7 @@ smt_convt::convert_ast(const expr2tc &expr)
       // No need to do anything.
       a = args[0];
     } else if(is_floatbv_type(abs.value)) {
-      a = mk_func_app(sort, SMT_FUNC_FABS, &args[0], 1);
+      a = fp_api->mk_smt_fpbv_abs(abs.value);
     } else {
       lessthan2tc lt(abs.value, gen_zero(abs.value->type));
       neg2tc neg(abs.value->type, abs.value);
@@ -905,6 +941,8 @@ smt_convt::convert_ast(const expr2tc &expr)
     // Pointer relation:
     if (is_pointer_type(lt.side_1)) {
       a = convert_ptr_cmp(lt.side_1, lt.side_2, expr);
+    } else if (is_floatbv_type(lt.side_1) && !int_encoding) {
+      a = fp_api->mk_smt_fpbv_lt(lt.side_1, lt.side_2);
     } else {
       a = convert_ast(expr, lt.side_1->type, args,
             expr_op_convert{
@@ -924,6 +962,8 @@ smt_convt::convert_ast(const expr2tc &expr)
     // Pointer relation:
     if (is_pointer_type(lte.side_1)) {
       a = convert_ptr_cmp(lte.side_1, lte.side_2, expr);
+    } else if (is_floatbv_type(lte.side_1) && !int_encoding) {
+      a = fp_api->mk_smt_fpbv_lte(lte.side_1, lte.side_2);
     } else {
       a = convert_ast(expr, lte.side_1->type, args,
             expr_op_convert{
@@ -943,6 +983,8 @@ smt_convt::convert_ast(const expr2tc &expr)
     // Pointer relation:
     if (is_pointer_type(gt.side_1)) {
       a = convert_ptr_cmp(gt.side_1, gt.side_2, expr);
+    } else if (is_floatbv_type(gt.side_1) && !int_encoding) {
+      a = fp_api->mk_smt_fpbv_gt(gt.side_1, gt.side_2);
     } else {
       a = convert_ast(expr, gt.side_1->type, args,
             expr_op_convert{
@@ -962,6 +1004,8 @@ smt_convt::convert_ast(const expr2tc &expr)
     // Pointer relation:
     if (is_pointer_type(gte.side_1)) {
       a = convert_ptr_cmp(gte.side_1, gte.side_2, expr);
+    } else if (is_floatbv_type(gte.side_1) && !int_encoding) {
+      a = fp_api->mk_smt_fpbv_gte(gte.side_1, gte.side_2);
     } else {
       a = convert_ast(expr, gte.side_1->type, args,
             expr_op_convert{
@@ -1115,6 +1159,11 @@ smt_convt::convert_ast(const expr2tc &expr)
   {
     assert(expr->get_num_sub_exprs() == 1);
 
+    if (is_floatbv_type(expr) && !int_encoding) {
+      a = fp_api->mk_smt_fpbv_neg(to_neg2t(expr).value);
+      break;
+    }
+
     a = convert_ast(expr, expr->type, args,
           expr_op_convert{
             SMT_FUNC_NEG,
@@ -1176,16 +1225,10 @@ smt_convt::convert_ast(const expr2tc &expr)
     bool to_float = is_floatbv_type(cast.type);
     bool from_float = is_floatbv_type(cast.from);
 
-    if ((to_float && !from_float) || (!to_float && from_float)) {
-      smt_func_kind k;
-
-      if (to_float)
-        k = SMT_FUNC_BV2FLOAT;
-      else
-        k = SMT_FUNC_FLOAT2BV;
-
-      a = convert_ast(expr, expr->type, args,
-            expr_op_convert{k, k, k, k, k});
+    if (to_float && !from_float) {
+      a = fp_api->mk_smt_bitcast_to_fpbv(cast);
+    } else if (!to_float && from_float) {
+      a = fp_api->mk_smt_bitcast_from_fpbv(cast);
     } else {
       // Cast by value is fine
       typecast2tc tcast(cast.type, cast.from);
@@ -1207,8 +1250,7 @@ smt_convt::convert_ast(const expr2tc &expr)
     abort();
   }
 
-  struct smt_cache_entryt entry = { expr, a, ctx_level };
-  smt_cache.insert(entry);
+  smt_cache.insert(expr, a);
 
   return a;
 }
@@ -1273,7 +1315,7 @@ smt_convt::convert_sort(const type2tc &type)
     {
       unsigned int sw = to_floatbv_type(type).fraction;
       unsigned int ew = to_floatbv_type(type).exponent;
-      result = mk_sort(SMT_SORT_FLOATBV, ew, sw);
+      result = fp_api->convert_fpbv_sort(ew, sw);
     }
     break;
   }
@@ -1502,9 +1544,7 @@ smt_convt::convert_is_nan(const expr2tc &expr)
   if(!is_floatbv_type(isnan.value))
     return mk_smt_bool(false);
 
-  smt_sortt bs = boolean_sort;
-  smt_astt operand = convert_ast(isnan.value);
-  return mk_func_app(bs, SMT_FUNC_ISNAN, operand);
+  return fp_api->mk_smt_fpbv_is_nan(isnan.value);
 }
 
 smt_astt smt_convt::convert_is_inf(const expr2tc& expr)
@@ -1515,9 +1555,7 @@ smt_astt smt_convt::convert_is_inf(const expr2tc& expr)
   if(!is_floatbv_type(isinf.value))
     return mk_smt_bool(false);
 
-  smt_sortt bs = boolean_sort;
-  smt_astt operand = convert_ast(isinf.value);
-  return mk_func_app(bs, SMT_FUNC_ISINF, operand);
+  return fp_api->mk_smt_fpbv_is_inf(isinf.value);
 }
 
 smt_astt smt_convt::convert_is_normal(const expr2tc& expr)
@@ -1528,9 +1566,7 @@ smt_astt smt_convt::convert_is_normal(const expr2tc& expr)
   if(!is_floatbv_type(isnormal.value))
     return mk_smt_bool(true);
 
-  smt_sortt bs = boolean_sort;
-  smt_astt operand = convert_ast(isnormal.value);
-  return mk_func_app(bs, SMT_FUNC_ISNORMAL, operand);
+  return fp_api->mk_smt_fpbv_is_normal(isnormal.value);
 }
 
 smt_astt smt_convt::convert_is_finite(const expr2tc& expr)
@@ -1567,7 +1603,7 @@ smt_astt smt_convt::convert_signbit(const expr2tc& expr)
   // For fixedbvs, we check if it's < 0
   smt_astt is_neg;
   if(!config.ansi_c.use_fixed_for_float && !int_encoding)
-    is_neg = mk_func_app(boolean_sort, SMT_FUNC_ISNEG, value);
+    is_neg = fp_api->mk_smt_fpbv_is_neg(signbit.operand);
   else
   {
     is_neg =
@@ -1590,11 +1626,8 @@ smt_astt smt_convt::convert_signbit(const expr2tc& expr)
 smt_astt
 smt_convt::convert_ieee_equal(const expr2tc &expr)
 {
-  smt_sortt bs = boolean_sort;
-  smt_astt s1 = convert_ast(*expr->get_sub_expr(0));
-  smt_astt s2 = convert_ast(*expr->get_sub_expr(1));
-
-  return mk_func_app(bs, SMT_FUNC_IEEE_EQ, s1, s2);
+  return fp_api->mk_smt_fpbv_eq(*expr->get_sub_expr(0),
+                                *expr->get_sub_expr(1));
 }
 
 smt_astt smt_convt::convert_rounding_mode(const expr2tc& expr)
@@ -1639,17 +1672,17 @@ smt_astt smt_convt::convert_rounding_mode(const expr2tc& expr)
 
   smt_astt ite2 =
     mk_func_app(
-      mk_sort(SMT_SORT_FLOATBV_RM),
+      ne->sort,
       SMT_FUNC_ITE, is_eq_two, pi, ze);
 
   smt_astt ite1 =
     mk_func_app(
-      mk_sort(SMT_SORT_FLOATBV_RM),
+      ne->sort,
       SMT_FUNC_ITE, is_eq_one, mi, ite2);
 
   smt_astt ite0 =
     mk_func_app(
-      mk_sort(SMT_SORT_FLOATBV_RM),
+      ne->sort,
       SMT_FUNC_ITE, is_eq_zero, ne, ite1);
 
   return ite0;
@@ -2459,6 +2492,67 @@ smt_convt::get_by_type(const expr2tc &expr)
   }
 }
 
+smt_convt::resultt
+smt_convt::dec_solve_assuming(const ast_vec &assumptions)
+{
+  push_ctx();
+  for (smt_astt a : assumptions)
+    assert_ast(a);
+  resultt res = dec_solve_refined();
+  pop_ctx();
+  return res;
+}
+
+smt_convt::resultt
+smt_convt::dec_solve_refined()
+{
+  // Each round adds lemmas that the next model can't break, and there are
+  // only so many of them, so this terminates.
+  resultt res = dec_solve();
+  while (res == P_SATISFIABLE && array_api->refine_array_model())
+    res = dec_solve();
+
+  return res;
+}
+
+void
+smt_convt::prefetch_values(const std::vector<smt_astt> &asts
+                           __attribute__((unused)))
+{
+}
+
+static void
+collect_prefetch_syms(const expr2tc &expr, std::vector<expr2tc> &syms)
+{
+  if (is_nil_expr(expr) || is_constant_number(expr))
+    return;
+
+  if (is_symbol2t(expr)) {
+    if (is_bool_type(expr) || is_bv_type(expr) || is_fixedbv_type(expr))
+      syms.push_back(expr);
+    return;
+  }
+
+  expr->foreach_operand([&syms] (const expr2tc &e) {
+    collect_prefetch_syms(e, syms);
+  });
+}
+
+void
+smt_convt::prefetch(const std::vector<expr2tc> &exprs)
+{
+  std::vector<expr2tc> syms;
+  for (const expr2tc &e : exprs)
+    collect_prefetch_syms(e, syms);
+
+  std::vector<smt_astt> asts;
+  asts.reserve(syms.size());
+  for (const expr2tc &sym : syms)
+    asts.push_back(convert_ast(sym));
+
+  prefetch_values(asts);
+}
+
 expr2tc
 smt_convt::get_array(const expr2tc &expr)
 {
@@ -8,6 +8,8 @@
 #include <cstdint>
 #include <solvers/prop/literal.h>
 #include <solvers/prop/pointer_logic.h>
+#include <solvers/smt/smt_region.h>
+#include <solvers/smt/smt_scoped_cache.h>
 #include <util/irep2_utils.h>
 #include <util/message.h>
 #include <util/namespace.h>
@@ -285,6 +287,12 @@ public:
 
   virtual ~smt_sort() = default;
 
+  /** Sorts are allocated with new (ctx), from a region that lives as long as
+   *  the converter ctx, and are never individually deleted. */
+  static void *operator new(size_t size, smt_convt *ctx);
+  static void operator delete(void *, smt_convt *) { }
+  static void operator delete(void *) { }
+
 private:
   /** Data size of the sort.
    * For bitvectors and floating-points this is the bit width,
@@ -343,6 +351,13 @@ public:
   smt_ast(smt_convt *ctx, smt_sortt s);
   virtual ~smt_ast() = default;
 
+  /** ASTs are allocated with new (ctx), from the region of the context level
+   *  they are made in, and are destroyed by smt_convt when that level is
+   *  popped; never delete one. */
+  static void *operator new(size_t size, smt_convt *ctx);
+  static void operator delete(void *, smt_convt *) { }
+  static void operator delete(void *) { }
+
   // "this" is the true operand.
   virtual smt_astt ite(smt_convt *ctx, smt_astt cond,
       smt_astt falseop) const;
@@ -529,6 +544,23 @@ public:
    *  @return Result code of the call to the solver. */
   virtual resultt dec_solve() = 0;
 
+  /** Solve the formula under some assumptions: boolean ASTs that are taken
+   *  to be true for this one check, without being asserted. A caller can then
+   *  ask several questions of one formula without a push and pop for each.
+   *  The default implementation does push a context, assert the assumptions,
+   *  solve and pop; so there's only a model to fetch afterwards from solvers
+   *  that override this.
+   *  @param assumptions Boolean sorted ASTs to assume true.
+   *  @return Result code of the call to the solver. */
+  virtual resultt dec_solve_assuming(const ast_vec &assumptions);
+
+  /** Solve with dec_solve, and then, for as long as the model breaks array
+   *  axioms that were left to be added on demand, assert those and solve
+   *  again. Anything that goes on to use the model should solve through
+   *  this rather than dec_solve.
+   *  @return Result code of the last call to the solver. */
+  resultt dec_solve_refined();
+
   void pre_solve();
 
   /** Get the satisfying assignment using the type.
@@ -568,16 +600,31 @@ public:
    *  @return A three-valued return val, of the assignment to a. */
   virtual tvt l_get(smt_astt a);
 
+  /** Fetch the model's values for a batch of ASTs in one go, ahead of the
+   *  get_bool / get_bv calls that will ask for them. Solvers where each query
+   *  is expensive, such as a pipe to another process, should override this
+   *  and answer those calls from what's fetched here, until the formula next
+   *  changes. By default this does nothing.
+   *  @param asts Boolean, or bitvector symbol, ASTs to fetch the value of. */
+  virtual void prefetch_values(const std::vector<smt_astt> &asts);
+
+  /** Prefetch the values that calls to get() on each of exprs will need from
+   *  the model. Only scalar symbols are found; anything else is still fetched
+   *  when get() is called.
+   *  @param exprs Expressions that are about to be passed to get(). */
+  void prefetch(const std::vector<expr2tc> &exprs);
+
   /** @} */
 
   /** @{
    *  @name Internal conversion API between smt_convt and solver converter */
 
-  /** Create an SMT function application. Using the provided information,
-   *  the solver converter should create a function application in the solver
-   *  being used, then wrap it in an smt_ast, and return it. If the desired
-   *  function application is not supported by the solver, print an error and
-   *  abort.
+  /** Create an SMT function application. If an identical application (same
+   *  kind, sort and argument ASTs) has already been made in this or an
+   *  enclosing context, that AST is returned again; otherwise it's made with
+   *  mk_func_app_impl. Repeated lowering of the same expressions then
+   *  produces a DAG rather than copies of one tree, which matters to solvers
+   *  that don't hash-cons terms themselves.
    *
    *  @param s The resulting sort of the func app we are creating.
    *  @param k The kind of function application to create.
@@ -585,9 +632,18 @@ public:
    *  @param numargs The number of elements in args. Should be consistent with
    *         the function kind k.
    *  @return The resulting function application, wrapped in an smt_ast. */
-  virtual smt_astt mk_func_app(smt_sortt s, smt_func_kind k,
-                               smt_astt  const *args,
-                               unsigned int numargs) = 0;
+  smt_astt mk_func_app(smt_sortt s, smt_func_kind k,
+                       smt_astt  const *args,
+                       unsigned int numargs);
+
+  /** Actually create an SMT function application. Using the provided
+   *  information, the solver converter should create a function application
+   *  in the solver being used, then wrap it in an smt_ast, and return it. If
+   *  the desired function application is not supported by the solver, print
+   *  an error and abort. Parameters are as for mk_func_app. */
+  virtual smt_astt mk_func_app_impl(smt_sortt s, smt_func_kind k,
+                                    smt_astt  const *args,
+                                    unsigned int numargs) = 0;
 
   // Some helpers
 
@@ -985,26 +1041,54 @@ public:
 
   // Type for (optional) AST cache
 
-  struct smt_cache_entryt {
-    const expr2tc val;
-    smt_astt ast;
-    unsigned int level;
+  typedef smt_scoped_cachet<expr2tc, smt_astt, irep2_hash> smt_cachet;
+
+  typedef flat_hash_map_cont<type2tc, smt_sortt, type2_hash> smt_sort_cachet;
+
+  // Type for the structural hash of function applications made by
+  // mk_func_app. Sorts are compared by kind and width, as different calls
+  // make their own sort objects; except for arrays, whose range sorts can
+  // differ at the same width.
+
+  struct func_app_keyt {
+    smt_func_kind kind;
+    smt_sort_kind sort_kind;
+    size_t width;
+    size_t secondary_width;
+    smt_sortt array_sort;
+    unsigned int numargs;
+    smt_astt args[4];
+
+    bool operator==(const func_app_keyt &ref) const
+    {
+      if (kind != ref.kind || sort_kind != ref.sort_kind ||
+          width != ref.width || secondary_width != ref.secondary_width ||
+          array_sort != ref.array_sort || numargs != ref.numargs)
+        return false;
+
+      for (unsigned int i = 0; i < numargs; i++)
+        if (args[i] != ref.args[i])
+          return false;
+      return true;
+    }
   };
 
-  typedef boost::multi_index_container<
-    smt_cache_entryt,
-    boost::multi_index::indexed_by<
-      boost::multi_index::hashed_unique<
-        BOOST_MULTI_INDEX_MEMBER(smt_cache_entryt, const expr2tc, val)
-      >,
-      boost::multi_index::ordered_non_unique<
-        BOOST_MULTI_INDEX_MEMBER(smt_cache_entryt, unsigned int, level),
-        std::greater<unsigned int>
-      >
-    >
-  > smt_cachet;
-
-  typedef hash_map_cont<type2tc, smt_sortt, type2_hash> smt_sort_cachet;
+  struct func_app_key_hash {
+    size_t operator()(const func_app_keyt &key) const
+    {
+      size_t h = key.kind;
+      h = h * 31 + key.sort_kind;
+      h = h * 31 + key.width;
+      h = h * 31 + key.secondary_width;
+      h = h * 31 + reinterpret_cast<size_t>(key.array_sort);
+      for (unsigned int i = 0; i < key.numargs; i++)
+        h = h * 31 + (reinterpret_cast<size_t>(key.args[i]) >> 3);
+      return h;
+    }
+  };
+
+  typedef smt_scoped_cachet<func_app_keyt, smt_astt, func_app_key_hash>
+    func_app_cachet;
 
   // Members
   /** Number of un-popped context pushes encountered so far. */
@@ -1014,6 +1098,8 @@ public:
   smt_cachet smt_cache;
   /** A cache of converted type2tc's to smt sorts */
   smt_sort_cachet sort_cache;
+  /** Function applications already made, see mk_func_app. */
+  func_app_cachet func_app_cache;
   /** Pointer_logict object, which contains some code for formatting how
    *  pointers are displayed in counter-examples. This is a list so that we
    *  can push and pop data when context push/pop operations occur. */
@@ -1085,6 +1171,12 @@ public:
    *  contained when a push occurred. On pop, the live_asts vector is reset
    *  back to that point. */
   std::vector<unsigned int> live_asts_sizes;
+  /** Memory of the ASTs in live_asts, marked at each push and released back
+   *  to the mark on pop, once the ASTs have been destroyed. */
+  smt_regiont ast_region;
+  std::vector<smt_regiont::markt> ast_region_marks;
+  /** Memory of every sort, which sort_cache keeps across pops. */
+  smt_regiont sort_region;
 
   tuple_iface *tuple_api;
   array_iface *array_api;
@@ -1105,4 +1197,16 @@ smt_ast::smt_ast(smt_convt *ctx, smt_sortt s) : sort(s) {
   ctx->live_asts.push_back(this);
 }
 
+inline void *
+smt_ast::operator new(size_t size, smt_convt *ctx)
+{
+  return ctx->ast_region.alloc(size);
+}
+
+inline void *
+smt_sort::operator new(size_t size, smt_convt *ctx)
+{
+  return ctx->sort_region.alloc(size);
+}
+
 #endif /* _ESBMC_PROP_SMT_SMT_CONV_H_ */
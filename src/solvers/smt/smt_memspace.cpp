@@ -214,8 +214,7 @@ smt_convt::renumber_symbol_address(
 
     // Now merge with the old value for all future address-of's
 
-    it->second = mk_func_app(output->sort, SMT_FUNC_ITE,
-                             convert_ast(guard), output, it->second);
+    it->second = output->ite(this, convert_ast(guard), it->second);
   } else {
     // Newly bumped pointer. Still needs a new number though.
     unsigned int obj_num = pointer_logic.back().get_free_obj_num();
@@ -258,9 +257,9 @@ smt_convt::convert_identifier_pointer(const expr2tc &expr, const std::string& sy
   // expression this is sourced from might have ended up with the wrong type,
   // alas.
   address_of2tc new_addr_of(expr->type, expr);
-  smt_cachet::const_iterator cache_result = smt_cache.find(new_addr_of);
-  if (cache_result != smt_cache.end())
-    return (cache_result->ast);
+  const smt_astt *cache_result = smt_cache.find(new_addr_of);
+  if (cache_result != nullptr)
+    return *cache_result;
 
   // Has this been touched by realloc / been re-numbered?
   renumber_mapt::iterator it = renumber_map.back().find(symbol);
@@ -311,8 +310,7 @@ smt_convt::convert_identifier_pointer(const expr2tc &expr, const std::string& sy
   }
 
   // Insert canonical address-of this expression.
-  struct smt_cache_entryt entry = { new_addr_of, a, ctx_level };
-  smt_cache.insert(entry);
+  smt_cache.insert(new_addr_of, a);
 
   return a;
 }
@@ -0,0 +1,227 @@
+#include <solvers/smt/smt_conv.h>
+#include <solvers/smt/smt_packed_ptr.h>
+#include <util/c_types.h>
+
+/* Pointers as one bitvector each; see smt_packed_ptr.h. Both fields read as,
+ * and are written from, machine pointer width bitvectors, just as the fields
+ * of the pointer tuple are, so nothing else in the converter needs to know
+ * which encoding is in use. */
+
+smt_packed_ptr_flattener::smt_packed_ptr_flattener(smt_convt *_ctx,
+    tuple_iface *_tuple_api, unsigned int _obj_bits)
+  : ctx(_ctx), tuple_api(_tuple_api), obj_bits(_obj_bits),
+    offs_bits(config.ansi_c.pointer_width)
+{
+  assert(obj_bits != 0 && obj_bits <= offs_bits);
+
+  ptr_sort = new (ctx) packed_ptr_smt_sort(obj_bits + offs_bits);
+  bits_sort = ctx->mk_sort(SMT_SORT_UBV, obj_bits + offs_bits);
+  obj_sort = ctx->mk_sort(SMT_SORT_UBV, obj_bits);
+  offs_sort = ctx->mk_sort(SMT_SORT_UBV, offs_bits);
+}
+
+smt_astt
+smt_packed_ptr_flattener::mk_ptr(smt_astt bits)
+{
+  return new (ctx) packed_ptr_smt_ast(*this, ctx, ptr_sort, bits);
+}
+
+smt_astt
+packed_ptr_smt_ast::ite(smt_convt *ctx, smt_astt cond, smt_astt falseop) const
+{
+  smt_astt falsebits = to_packed_ptr_ast(falseop)->bits;
+  return flat.mk_ptr(bits->ite(ctx, cond, falsebits));
+}
+
+smt_astt
+packed_ptr_smt_ast::eq(smt_convt *ctx, smt_astt other) const
+{
+  return bits->eq(ctx, to_packed_ptr_ast(other)->bits);
+}
+
+smt_astt
+packed_ptr_smt_ast::update(smt_convt *ctx, smt_astt value, unsigned int idx,
+    expr2tc idx_expr __attribute__((unused)) /*ndebug*/) const
+{
+  assert(is_nil_expr(idx_expr) && "Can't apply non-constant index update to "
+         "pointer");
+  assert(idx < 2 && "Out-of-bounds pointer field updated");
+
+  unsigned int width = flat.obj_bits + flat.offs_bits;
+  smt_astt obj, offs;
+  if (idx == 0) {
+    // Object numbers never exceed the object bits, so dropping the top of the
+    // machine width value loses nothing
+    obj = ctx->mk_extract(value, flat.obj_bits - 1, 0, flat.obj_sort);
+    offs = ctx->mk_extract(bits, flat.offs_bits - 1, 0, flat.offs_sort);
+  } else {
+    obj = ctx->mk_extract(bits, width - 1, flat.offs_bits, flat.obj_sort);
+    offs = value;
+  }
+
+  return flat.mk_ptr(
+    ctx->mk_func_app(flat.bits_sort, SMT_FUNC_CONCAT, obj, offs));
+}
+
+smt_astt
+packed_ptr_smt_ast::select(smt_convt *ctx __attribute__((unused)),
+    const expr2tc &idx __attribute__((unused))) const
+{
+  std::cerr << "Select operation applied to pointer" << std::endl;
+  abort();
+}
+
+smt_astt
+packed_ptr_smt_ast::project(smt_convt *ctx, unsigned int idx) const
+{
+  assert(idx < 2 && "Out-of-bounds pointer field accessed");
+
+  if (idx == 1)
+    return ctx->mk_extract(bits, flat.offs_bits - 1, 0, flat.offs_sort);
+
+  unsigned int width = flat.obj_bits + flat.offs_bits;
+  smt_astt obj = ctx->mk_extract(bits, width - 1, flat.offs_bits,
+                                 flat.obj_sort);
+  if (flat.obj_bits == flat.offs_bits)
+    return obj;
+
+  return ctx->convert_zero_ext(obj, flat.offs_sort,
+                               flat.offs_bits - flat.obj_bits);
+}
+
+expr2tc
+packed_ptr_smt_ast::get(smt_convt *ctx) const
+{
+  // Fetched a field at a time, as solvers don't hand back values wider than
+  // 64 bits
+  expr2tc obj = ctx->get_bv(ctx->machine_ptr, project(ctx, 0));
+  expr2tc offs = ctx->get_bv(ctx->machine_ptr, project(ctx, 1));
+
+  // Guard against a pointer the solver didn't assign
+  if (!is_constant_int2t(obj) || !is_constant_int2t(offs))
+    return expr2tc();
+
+  uint64_t num = to_constant_int2t(obj).value.to_uint64();
+  pointer_logict::pointert p(num, BigInt(to_constant_int2t(offs).value));
+  return ctx->pointer_logic.back().pointer_expr(p,
+                               type2tc(new pointer_type2t(get_empty_type())));
+}
+
+smt_sortt
+smt_packed_ptr_flattener::mk_struct_sort(const type2tc &type)
+{
+  if (is_pointer_type(type) || type == ctx->pointer_struct)
+    return ptr_sort;
+
+  return tuple_api->mk_struct_sort(type);
+}
+
+smt_astt
+smt_packed_ptr_flattener::tuple_create(const expr2tc &structdef)
+{
+  if (!is_pointer_type(structdef) && structdef->type != ctx->pointer_struct)
+    return tuple_api->tuple_create(structdef);
+
+  assert(structdef->get_num_sub_exprs() == 2);
+  const expr2tc &obj = *structdef->get_sub_expr(0);
+  const expr2tc &offs = *structdef->get_sub_expr(1);
+
+  // Solvers take constants no wider than 64 bits, so pointers are put
+  // together from their two fields even when both are constant
+  smt_astt objbits;
+  if (is_constant_int2t(obj)) {
+    const BigInt &num = to_constant_int2t(obj).value;
+    if (num >= (BigInt(1) << BigInt(obj_bits))) {
+      std::cerr << "Pointer object " << num << " doesn't fit in the "
+                << obj_bits << " bits counted for packed pointers"
+                << std::endl;
+      abort();
+    }
+
+    objbits = ctx->mk_smt_bvint(num, false, obj_bits);
+  } else {
+    objbits =
+      ctx->mk_extract(ctx->convert_ast(obj), obj_bits - 1, 0, obj_sort);
+  }
+
+  return mk_ptr(ctx->mk_func_app(bits_sort, SMT_FUNC_CONCAT, objbits,
+                                 ctx->convert_ast(offs)));
+}
+
+smt_astt
+smt_packed_ptr_flattener::tuple_fresh(smt_sortt s, std::string name)
+{
+  if (s != ptr_sort)
+    return tuple_api->tuple_fresh(s, name);
+
+  if (name == "")
+    name = ctx->mk_fresh_name("packed_ptr_fresh::");
+
+  return mk_ptr(ctx->mk_smt_symbol(name, bits_sort));
+}
+
+smt_astt
+smt_packed_ptr_flattener::mk_tuple_symbol(const std::string &name, smt_sortt s)
+{
+  if (s != ptr_sort)
+    return tuple_api->mk_tuple_symbol(name, s);
+
+  // As with the node flattener, the special pointer names are never joined
+  // to their values through a symbol.
+  if (name == "0" || name == "NULL")
+    return ctx->null_ptr_ast;
+  else if (name == "INVALID")
+    return ctx->invalid_ptr_ast;
+
+  return mk_ptr(ctx->mk_smt_symbol(name, bits_sort));
+}
+
+expr2tc
+smt_packed_ptr_flattener::tuple_get(const expr2tc &expr)
+{
+  if (!is_pointer_type(expr) && expr->type != ctx->pointer_struct)
+    return tuple_api->tuple_get(expr);
+
+  return to_packed_ptr_ast(ctx->convert_ast(expr))->get(ctx);
+}
+
+smt_astt
+smt_packed_ptr_flattener::mk_tuple_array_symbol(const expr2tc &expr)
+{
+  return tuple_api->mk_tuple_array_symbol(expr);
+}
+
+smt_astt
+smt_packed_ptr_flattener::tuple_array_of(const expr2tc &init_value,
+                                         unsigned long domain_width)
+{
+  return tuple_api->tuple_array_of(init_value, domain_width);
+}
+
+smt_astt
+smt_packed_ptr_flattener::tuple_array_create(const type2tc &array_type,
+                                             smt_astt *input_args,
+                                             bool const_array,
+                                             smt_sortt domain)
+{
+  return tuple_api->tuple_array_create(array_type, input_args, const_array,
+                                       domain);
+}
+
+void
+smt_packed_ptr_flattener::add_tuple_constraints_for_solving()
+{
+  tuple_api->add_tuple_constraints_for_solving();
+}
+
+void
+smt_packed_ptr_flattener::push_tuple_ctx()
+{
+  tuple_api->push_tuple_ctx();
+}
+
+void
+smt_packed_ptr_flattener::pop_tuple_ctx()
+{
+  tuple_api->pop_tuple_ctx();
+}
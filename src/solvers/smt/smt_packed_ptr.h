@@ -0,0 +1,120 @@
+#ifndef _ESBMC_SOLVERS_SMT_SMT_PACKED_PTR_H_
+#define _ESBMC_SOLVERS_SMT_SMT_PACKED_PTR_H_
+
+#include <solvers/smt/smt_conv.h>
+#include <solvers/smt/smt_tuple.h>
+
+/** @file smt_packed_ptr.h
+ *  An alternative encoding of pointers, where instead of a (object, offset)
+ *  tuple a pointer is a single bitvector: the object number in the top bits,
+ *  and the offset in the bottom pointer-width bits. Pointer equality and ite
+ *  become single bitvector operations, and projecting the object or offset
+ *  becomes an extract, so that pointer heavy formulas stay in QF_BV rather
+ *  than being spread over pairs of variables.
+ *
+ *  The number of object bits is fixed before conversion starts, from a count
+ *  of the objects the formula can address; running out of them is fatal.
+ *
+ *  This sits in front of another tuple_iface: everything that isn't a pointer
+ *  (structs, and arrays of anything) is passed on to it. That interface must
+ *  keep struct members as separate ASTs, as the node flattener does, so that
+ *  a pointer member can be one of these. */
+
+class packed_ptr_smt_ast;
+class smt_packed_ptr_flattener;
+typedef const packed_ptr_smt_ast *packed_ptr_smt_astt;
+
+/** Sort of a packed pointer. Distinct from the sort of the bitvector it holds,
+ *  so that pointers are still recognisable as tuple sorted by the rest of the
+ *  converter. */
+class packed_ptr_smt_sort : public smt_sort
+{
+public:
+  packed_ptr_smt_sort(size_t width) : smt_sort(SMT_SORT_STRUCT, width) { }
+  ~packed_ptr_smt_sort() override = default;
+};
+
+class packed_ptr_smt_ast : public smt_ast {
+public:
+  packed_ptr_smt_ast(smt_packed_ptr_flattener &f, smt_convt *ctx, smt_sortt s,
+                     smt_astt _bits)
+    : smt_ast(ctx, s), bits(_bits), flat(f) { }
+  ~packed_ptr_smt_ast() override = default;
+
+  /** Bitvector holding the object number above the offset. */
+  smt_astt bits;
+
+  smt_packed_ptr_flattener &flat;
+
+  smt_astt ite(smt_convt *ctx, smt_astt cond,
+      smt_astt falseop) const override;
+  smt_astt eq(smt_convt *ctx, smt_astt other) const override;
+  smt_astt update(smt_convt *ctx, smt_astt value,
+                                unsigned int idx,
+                                expr2tc idx_expr = expr2tc()) const override;
+  smt_astt select(smt_convt *ctx, const expr2tc &idx) const override;
+  smt_astt project(smt_convt *ctx, unsigned int elem) const override;
+
+  void dump() const override { bits->dump(); }
+
+  /** Fetch this pointer's value from the model, as a pointer expression. */
+  expr2tc get(smt_convt *ctx) const;
+};
+
+inline bool
+is_packed_ptr_ast(smt_astt a)
+{
+  return dynamic_cast<packed_ptr_smt_astt>(a) != nullptr;
+}
+
+inline packed_ptr_smt_astt
+to_packed_ptr_ast(smt_astt a)
+{
+  packed_ptr_smt_astt pa = dynamic_cast<packed_ptr_smt_astt>(a);
+  assert(pa != nullptr && "Packed pointer AST mismatch");
+  return pa;
+}
+
+class smt_packed_ptr_flattener : public tuple_iface
+{
+public:
+  /** @param _tuple_api Interface that everything other than pointers is passed
+   *         on to.
+   *  @param _obj_bits Number of bits to hold the object number in. */
+  smt_packed_ptr_flattener(smt_convt *_ctx, tuple_iface *_tuple_api,
+                           unsigned int _obj_bits);
+
+  smt_sortt mk_struct_sort(const type2tc &type) override;
+  smt_astt tuple_create(const expr2tc &structdef) override;
+  smt_astt tuple_fresh(smt_sortt s, std::string name = "") override;
+  smt_astt mk_tuple_symbol(const std::string &name, smt_sortt s) override;
+  expr2tc tuple_get(const expr2tc &expr) override;
+
+  smt_astt mk_tuple_array_symbol(const expr2tc &expr) override;
+  smt_astt tuple_array_of(const expr2tc &init_value,
+                                            unsigned long domain_width) override;
+  smt_astt tuple_array_create(const type2tc &array_type,
+                                            smt_astt *input_args,
+                                            bool const_array,
+                                            smt_sortt domain) override;
+
+  void add_tuple_constraints_for_solving() override;
+  void push_tuple_ctx() override;
+  void pop_tuple_ctx() override;
+
+  /** Wrap a bitvector of bits_sort up as a pointer. */
+  smt_astt mk_ptr(smt_astt bits);
+
+  smt_convt *ctx;
+  tuple_iface *tuple_api;
+
+  unsigned int obj_bits;
+  unsigned int offs_bits;
+
+  smt_sortt ptr_sort;
+  smt_sortt bits_sort;
+  smt_sortt obj_sort;
+  smt_sortt offs_sort;
+};
+
+#endif /* _ESBMC_SOLVERS_SMT_SMT_PACKED_PTR_H_ */
@@ -0,0 +1,99 @@
+#ifndef _ESBMC_SOLVERS_SMT_SMT_REGION_H_
+#define _ESBMC_SOLVERS_SMT_SMT_REGION_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/** Bump allocator for objects that all die together. Memory is handed out
+ *  from large chunks and is never freed piecemeal: instead a mark is taken,
+ *  and releasing back to that mark gives up everything allocated since in one
+ *  go. Marks nest, which is how smt_convt ties ASTs to context levels.
+ *
+ *  The region only deals in memory. Running destructors, where they matter,
+ *  is up to whoever placed objects in it. */
+class smt_regiont
+{
+public:
+  struct markt
+  {
+    size_t num_chunks;
+    char *cur;
+    size_t left;
+  };
+
+  smt_regiont() : cur(nullptr), left(0) { }
+
+  smt_regiont(const smt_regiont &ref) = delete;
+  smt_regiont &operator=(const smt_regiont &ref) = delete;
+
+  ~smt_regiont()
+  {
+    release_all();
+  }
+
+  void *alloc(size_t size)
+  {
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (size > left)
+      new_chunk(size);
+
+    void *result = cur;
+    cur += size;
+    left -= size;
+    return result;
+  }
+
+  markt mark() const
+  {
+    markt m = { chunks.size(), cur, left };
+    return m;
+  }
+
+  /** Forget everything allocated since m was taken. The remainder of the
+   *  chunk that was current at the time is handed out again. */
+  void release(const markt &m)
+  {
+    while (chunks.size() > m.num_chunks) {
+      free(chunks.back());
+      chunks.pop_back();
+    }
+
+    cur = m.cur;
+    left = m.left;
+  }
+
+  void release_all()
+  {
+    markt m = { 0, nullptr, 0 };
+    release(m);
+  }
+
+  size_t num_chunks() const { return chunks.size(); }
+
+protected:
+  static const size_t alignment = alignof(std::max_align_t);
+  static const size_t chunk_size = 256 * 1024;
+
+  void new_chunk(size_t size)
+  {
+    // Oversized requests get a chunk of their own.
+    if (size < chunk_size)
+      size = chunk_size;
+
+    char *c = static_cast<char *>(malloc(size));
+    if (c == nullptr)
+      throw std::bad_alloc();
+
+    chunks.push_back(c);
+    cur = c;
+    left = size;
+  }
+
+  std::vector<char *> chunks;
+  char *cur;
+  size_t left;
+};
+
+#endif /* _ESBMC_SOLVERS_SMT_SMT_REGION_H_ */
@@ -0,0 +1,70 @@
+#ifndef _ESBMC_SOLVERS_SMT_SMT_SCOPED_CACHE_H_
+#define _ESBMC_SOLVERS_SMT_SMT_SCOPED_CACHE_H_
+
+#include <cstddef>
+#include <util/hash_cont.h>
+#include <vector>
+
+/** Hash map that follows the SMT context stack: whatever is inserted after a
+ *  push is forgotten again on the matching pop. Each insertion is recorded in
+ *  an undo log, so popping costs as much as was inserted in that context, and
+ *  nothing for the rest of the map.
+ *
+ *  Lookups are counted, so that how well a cache works can be reported.
+ *  Pointers returned by find are invalidated by the next insert or pop. */
+template <class Key, class Value, class Hash>
+class smt_scoped_cachet
+{
+public:
+  smt_scoped_cachet() : hits(0), misses(0) { }
+
+  const Value *find(const Key &key)
+  {
+    typename mapt::const_iterator it = map.find(key);
+    if (it == map.end()) {
+      misses++;
+      return nullptr;
+    }
+
+    hits++;
+    return &it->second;
+  }
+
+  /** Does nothing if key is already present, as with std::map::insert. */
+  void insert(const Key &key, const Value &val)
+  {
+    if (map.insert(std::make_pair(key, val)).second)
+      undo_log.push_back(key);
+  }
+
+  void push()
+  {
+    scopes.push_back(undo_log.size());
+  }
+
+  void pop()
+  {
+    size_t start = scopes.back();
+    scopes.pop_back();
+
+    for (size_t i = start; i < undo_log.size(); i++)
+      map.erase(undo_log[i]);
+    undo_log.resize(start);
+  }
+
+  size_t size() const { return map.size(); }
+
+  unsigned long hits;
+  unsigned long misses;
+
+protected:
+  typedef flat_hash_map_cont<Key, Value, Hash> mapt;
+
+  mapt map;
+  /** Keys in order of insertion. */
+  std::vector<Key> undo_log;
+  /** Size of the undo log at each push. */
+  std::vector<size_t> scopes;
+};
+
+#endif /* _ESBMC_SOLVERS_SMT_SMT_SCOPED_CACHE_H_ */
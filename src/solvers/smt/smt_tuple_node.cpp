@@ -1,4 +1,5 @@
 #include <solvers/smt/smt_conv.h>
+#include <solvers/smt/smt_packed_ptr.h>
 #include <solvers/smt/smt_tuple.h>
 #include <solvers/smt/smt_tuple_flat.h>
 #include <sstream>
@@ -59,7 +60,7 @@ tuple_node_smt_ast::ite(smt_convt *ctx, smt_astt cond, smt_astt falseop) const
   tuple_smt_sortt thissort = to_tuple_sort(sort);
   std::string name = ctx->mk_fresh_name("tuple_ite::") + ".";
   tuple_node_smt_ast *result_sym =
-    new tuple_node_smt_ast(flat, ctx, sort, name);
+    new (ctx) tuple_node_smt_ast(flat, ctx, sort, name);
 
   const_cast<tuple_node_smt_ast*>(true_val)->make_free(ctx);
   const_cast<tuple_node_smt_ast*>(false_val)->make_free(ctx);
@@ -134,7 +135,7 @@ tuple_node_smt_ast::update(smt_convt *ctx, smt_astt value, unsigned int idx,
          "structure");
 
   std::string name = ctx->mk_fresh_name("tuple_update::") + ".";
-  tuple_node_smt_ast *result = new tuple_node_smt_ast(flat, ctx, sort, name);
+  tuple_node_smt_ast *result = new (ctx) tuple_node_smt_ast(flat, ctx, sort, name);
   result->elements = elements;
   result->make_free(ctx);
   result->elements[idx] = value;
@@ -181,7 +182,7 @@ smt_tuple_node_flattener::tuple_create(const expr2tc &structdef)
   name += ".";
 
   tuple_node_smt_ast *result =
-    new tuple_node_smt_ast(*this, ctx, ctx->convert_sort(structdef->type),
+    new (ctx) tuple_node_smt_ast(*this, ctx, ctx->convert_sort(structdef->type),
                            name);
   result->elements.resize(structdef->get_num_sub_exprs());
 
@@ -205,7 +206,7 @@ smt_tuple_node_flattener::tuple_fresh(smt_sortt s, std::string name)
     smt_sortt subtype = ctx->convert_sort(to_array_type(sort->thetype).subtype);
     return array_conv.mk_array_symbol(name, s, subtype);
   } else {
-    return new tuple_node_smt_ast(*this, ctx, s, name);
+    return new (ctx) tuple_node_smt_ast(*this, ctx, s, name);
   }
 }
 
@@ -228,7 +229,7 @@ smt_tuple_node_flattener::mk_tuple_symbol(const std::string &name, smt_sortt s)
     name2 += ".";
 
   assert(s->id != SMT_SORT_ARRAY);
-  return new tuple_node_smt_ast(*this, ctx, s, name2);
+  return new (ctx) tuple_node_smt_ast(*this, ctx, s, name2);
 }
 
 smt_astt
@@ -321,7 +322,9 @@ smt_tuple_node_flattener::tuple_get_rec(tuple_node_smt_astt tuple)
   for(auto const &it : strct.members)
   {
     expr2tc res;
-    if (is_tuple_ast_type(it)) {
+    if (is_pointer_type(it) && is_packed_ptr_ast(tuple->elements[i])) {
+      res = to_packed_ptr_ast(tuple->elements[i])->get(ctx);
+    } else if (is_tuple_ast_type(it)) {
       res = tuple_get_rec(to_tuple_node_ast(tuple->elements[i]));
     } else if (is_tuple_array_ast_type(it)) {
       res = expr2tc(); // XXX currently unimplemented
@@ -367,7 +370,7 @@ smt_tuple_node_flattener::tuple_array_of(const expr2tc &init_val, unsigned long
   uint64_t elems = 1ULL << array_size;
   type2tc array_type =
     type2tc(new array_type2t(init_val->type, gen_ulong(elems), false));
-  smt_sortt array_sort = new tuple_smt_sort(array_type, 1, array_size);
+  smt_sortt array_sort = new (ctx) tuple_smt_sort(array_type, 1, array_size);
 
   return array_conv.convert_array_of_wsort(ctx->convert_ast(init_val),
     array_size, array_sort);
@@ -382,9 +385,9 @@ smt_tuple_node_flattener::mk_struct_sort(const type2tc &type)
     assert(!is_array_type(arrtype.subtype) && "Arrays dimensions should be flattened by the time they reach tuple interface");
     unsigned int dom_width = ctx->calculate_array_domain_width(arrtype);
     // NB: the range value is a dummy.
-    return new tuple_smt_sort(type, 1, dom_width);
+    return new (ctx) tuple_smt_sort(type, 1, dom_width);
   } else {
-    return new tuple_smt_sort(type);
+    return new (ctx) tuple_smt_sort(type);
   }
 }
 
@@ -195,7 +195,7 @@ tuple_sym_smt_ast::update(smt_convt *ctx, smt_astt value, unsigned int idx,
   const struct_union_data &data = ctx->get_type_def(ts->thetype);
 
   std::string name = ctx->mk_fresh_name("tuple_update::") + ".";
-  tuple_sym_smt_astt result = new tuple_sym_smt_ast(ctx, sort, name);
+  tuple_sym_smt_astt result = new (ctx) tuple_sym_smt_ast(ctx, sort, name);
 
   // Iterate over all members, deciding what to do with them.
   for(unsigned int j = 0; j < data.members.size(); j++)
@@ -237,7 +237,7 @@ array_sym_smt_ast::update(smt_convt *ctx, smt_astt value, unsigned int idx,
   }
 
   std::string name = ctx->mk_fresh_name("tuple_array_update::") + ".";
-  tuple_sym_smt_astt result = new array_sym_smt_ast(ctx, sort, name);
+  tuple_sym_smt_astt result = new (ctx) array_sym_smt_ast(ctx, sort, name);
 
   // Iterate over all members. They are _all_ indexed and updated.
   unsigned int i = 0;
@@ -278,7 +278,7 @@ array_sym_smt_ast::select(smt_convt *ctx, const expr2tc &idx) const
   smt_sortt result_sort = ctx->convert_sort(array_type.subtype);
 
   std::string name = ctx->mk_fresh_name("tuple_array_select::") + ".";
-  tuple_sym_smt_astt result = new tuple_sym_smt_ast(ctx, result_sort, name);
+  tuple_sym_smt_astt result = new (ctx) tuple_sym_smt_ast(ctx, result_sort, name);
 
   unsigned int i = 0;
   for(auto const &it : data.members)
@@ -322,9 +322,9 @@ tuple_sym_smt_ast::project(smt_convt *ctx, unsigned int idx) const
     // the internal struct being projected.
     sym_name = sym_name + ".";
     if (is_tuple_array_ast_type(restype))
-      return new array_sym_smt_ast(ctx, s, sym_name);
+      return new (ctx) array_sym_smt_ast(ctx, s, sym_name);
     else
-      return new tuple_sym_smt_ast(ctx, s, sym_name);
+      return new (ctx) tuple_sym_smt_ast(ctx, s, sym_name);
   } else {
     // This is a normal variable, so create a normal symbol of its name.
     return ctx->mk_smt_symbol(sym_name, s);
@@ -356,7 +356,7 @@ array_sym_smt_ast::project(smt_convt *ctx, unsigned int idx) const
     // This is a struct within a struct, so just generate the name prefix of
     // the internal struct being projected.
     sym_name = sym_name + ".";
-    return new array_sym_smt_ast(ctx, s, sym_name);
+    return new (ctx) array_sym_smt_ast(ctx, s, sym_name);
   } else {
     // This is a normal variable, so create a normal symbol of its name.
     return ctx->mk_smt_symbol(sym_name, s);
@@ -397,7 +397,7 @@ smt_tuple_sym_flattener::tuple_create(const expr2tc &structdef)
   name += ".";
 
   smt_ast *result =
-    new tuple_sym_smt_ast(ctx, ctx->convert_sort(structdef->type),name);
+    new (ctx) tuple_sym_smt_ast(ctx, ctx->convert_sort(structdef->type),name);
 
   for (unsigned int i = 0; i < structdef->get_num_sub_exprs(); i++) {
     smt_astt tmp = ctx->convert_ast(*structdef->get_sub_expr(i));
@@ -415,9 +415,9 @@ smt_tuple_sym_flattener::tuple_fresh(smt_sortt s, std::string name)
                                : name;
 
   if (s->id == SMT_SORT_ARRAY)
-    return new array_sym_smt_ast(ctx, s, n);
+    return new (ctx) array_sym_smt_ast(ctx, s, n);
   else
-    return new tuple_sym_smt_ast(ctx, s, n);
+    return new (ctx) tuple_sym_smt_ast(ctx, s, n);
 }
 
 smt_astt
@@ -432,7 +432,7 @@ smt_tuple_sym_flattener::mk_tuple_symbol(const std::string &name, smt_sortt s)
     name2 += ".";
 
   assert(s->id != SMT_SORT_ARRAY);
-  return new tuple_sym_smt_ast(ctx, s, name2);
+  return new (ctx) tuple_sym_smt_ast(ctx, s, name2);
 }
 
 smt_astt
@@ -442,7 +442,7 @@ smt_tuple_sym_flattener::mk_tuple_array_symbol(const expr2tc &expr)
   const symbol2t &sym = to_symbol2t(expr);
   std::string name = sym.get_symbol_name() + "[]";
   smt_sortt sort = ctx->convert_sort(sym.type);
-  return new array_sym_smt_ast(ctx, sort, name);
+  return new (ctx) array_sym_smt_ast(ctx, sort, name);
 }
 
 smt_astt
@@ -458,7 +458,7 @@ smt_tuple_sym_flattener::tuple_array_create(const type2tc &array_type,
   // XXX - probably more efficient to update each member array, but not now.
   smt_sortt sort = ctx->convert_sort(array_type);
   std::string name = ctx->mk_fresh_name("tuple_array_create::") + ".";
-  smt_astt newsym = new array_sym_smt_ast(ctx, sort, name);
+  smt_astt newsym = new (ctx) array_sym_smt_ast(ctx, sort, name);
 
   // Check size
   const array_type2t &arr_type = to_array_type(array_type);
@@ -552,7 +552,7 @@ smt_tuple_sym_flattener::tuple_array_of(const expr2tc &init_val, unsigned long a
   symbol2tc tuple_arr_of_sym(arrtype, irep_idt(name));
 
   smt_sortt sort = ctx->convert_sort(arrtype);
-  smt_astt newsym = new array_sym_smt_ast(ctx, sort, name);
+  smt_astt newsym = new (ctx) array_sym_smt_ast(ctx, sort, name);
 
   assert(subtype.members.size() == data.datatype_members.size());
   for (unsigned long i = 0; i < subtype.members.size(); i++) {
@@ -577,9 +577,9 @@ smt_tuple_sym_flattener::mk_struct_sort(const type2tc &type)
     const array_type2t &arrtype = to_array_type(type);
     assert(!is_array_type(arrtype.subtype) && "Arrays dimensions should be flattened by the time they reach tuple interface");
     unsigned int dom_width = ctx->calculate_array_domain_width(arrtype);
-    return new tuple_smt_sort(type, 1, dom_width);
+    return new (ctx) tuple_smt_sort(type, 1, dom_width);
   } else {
-    return new tuple_smt_sort(type);
+    return new (ctx) tuple_smt_sort(type);
   }
 }
 
@@ -198,7 +198,7 @@ smt_convt_wrapper::smt_convt_wrapper(bool int_encoding, const namespacet &_ns,
 }
 
 smt_astt
-smt_convt_wrapper::mk_func_app(smt_sortt s, smt_func_kind k, smt_astt const *args, unsigned int numargs)
+smt_convt_wrapper::mk_func_app_impl(smt_sortt s, smt_func_kind k, smt_astt const *args, unsigned int numargs)
 {
   // Python is not going to enjoy variable length argument array in any way
   using namespace boost::python;
@@ -6,6 +6,7 @@
 #include <smtlib.hpp>
 #include <smtlib_tok.hpp>
 #include <sstream>
+#include <sys/wait.h>
 #include <unistd.h>
 
 // Dec of external lexer input stream
@@ -165,6 +166,16 @@ smtlib_convt::smtlib_convt(bool int_encoding, const namespacet &_ns,
 smtlib_convt::~smtlib_convt()
 {
   delete_all_asts();
+
+  // The solver process lives as long as we do, across every query.
+  if (in_stream != nullptr) {
+    fprintf(out_stream, "(exit)\n");
+    fclose(out_stream);
+    fclose(in_stream);
+    waitpid(solver_proc_pid, nullptr, 0);
+  } else {
+    fclose(out_stream);
+  }
 }
 
 std::string
@@ -247,12 +258,33 @@ smtlib_convt::emit_terminal_ast(const smtlib_smt_ast *ast, std::string &output)
   }
 }
 
-unsigned int
-smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
+std::string
+smtlib_convt::func_app_string(const smtlib_smt_ast *ast,
+                              const std::string *args) const
 {
-  unsigned int brace_level = 0, i;
-  std::string args[4];
+  std::stringstream ss;
+
+  // This asts function
+  assert((int)ast->kind <= (int)expr2t::end_expr_id);
+  if (ast->kind == SMT_FUNC_EXTRACT) {
+    // Extract is an indexed function
+    ss << "((_ extract " << ast->extract_high << " " << ast->extract_low
+       << ")";
+  } else {
+    ss << "(" << smt_func_name_table[ast->kind];
+  }
+
+  // Its operands
+  for (unsigned int i = 0; i < ast->num_args; i++)
+    ss << " " << args[i];
 
+  ss << ")";
+  return ss.str();
+}
+
+static bool
+is_terminal_ast(const smtlib_smt_ast *ast)
+{
   switch (ast->kind) {
   case SMT_FUNC_HACKS:
   case SMT_FUNC_INVALID:
@@ -264,51 +296,78 @@ smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
   case SMT_FUNC_BVINT:
   case SMT_FUNC_REAL:
   case SMT_FUNC_SYMBOL:
-    return emit_terminal_ast(ast, output);
+    return true;
   default:
-    break;
-    // Continue.
+    return false;
   }
+}
 
-  for (i = 0; i < ast->num_args; i++)
-    brace_level += emit_ast(static_cast<const smtlib_smt_ast *>(ast->args[i]),
-                            args[i]);
+void
+smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
+{
+  // The algorithm: give each function application its own temporary symbol
+  // with define-fun, after doing the same for its operands, and refer to it
+  // by that name from then on. Output is linear in the size of the DAG; a
+  // term shared between assertions is only printed the once.
+  if (is_terminal_ast(ast)) {
+    emit_terminal_ast(ast, output);
+    return;
+  }
 
-  // Get a temporary sym name
-  unsigned int tempnum = temp_sym_count.back()++;
   std::stringstream ss;
+  defined_astst::iterator it = defined_asts.find(ast);
+  if (it != defined_asts.end()) {
+    ss << temp_prefix << it->num;
+    output = ss.str();
+    return;
+  }
+
+  std::string args[4];
+  for (unsigned int i = 0; i < ast->num_args; i++)
+    emit_ast(static_cast<const smtlib_smt_ast *>(ast->args[i]), args[i]);
+
+  // Get a temporary sym name
+  unsigned long tempnum = temp_sym_count.back()++;
   ss << temp_prefix << tempnum;
-  std::string tempname = ss.str();
+  output = ss.str();
 
-  // Emit a let, assigning the result of this AST func to the sym.
-  // For some reason let requires a double-braced operand.
-  fprintf(out_stream, "(let ((%s (", tempname.c_str());
+  fprintf(out_stream, "(define-fun %s () %s %s)\n", output.c_str(),
+          sort_to_string(ast->sort).c_str(),
+          func_app_string(ast, args).c_str());
 
-  // This asts function
-  assert((int)ast->kind <= (int)expr2t::end_expr_id);
-  if (ast->kind == SMT_FUNC_EXTRACT) {
-    // Extract is an indexed function
-    fprintf(out_stream, "(_ extract %d %d)", ast->extract_high,
-                                             ast->extract_low);
-  } else {
-    fprintf(out_stream, "%s", smt_func_name_table[ast->kind].c_str());
+  defined_ast_rec rec = { ast, ctx_level, tempnum };
+  defined_asts.insert(rec);
+}
+
+std::string
+smtlib_convt::inline_ast(const smtlib_smt_ast *ast)
+{
+  // As emit_ast, but without defining anything new: after a check-sat, any
+  // further definition would leave the solver unable to answer get-value.
+  std::string output;
+  if (is_terminal_ast(ast)) {
+    emit_terminal_ast(ast, output);
+    return output;
   }
 
-  // Its operands
-  for (i = 0; i < ast->num_args; i++)
-    fprintf(out_stream, " %s", args[i].c_str());
+  defined_astst::iterator it = defined_asts.find(ast);
+  if (it != defined_asts.end()) {
+    std::stringstream ss;
+    ss << temp_prefix << it->num;
+    return ss.str();
+  }
 
-  // End func enclosing brace, then operand to let (two braces).
-  fprintf(out_stream, ")))\n");
+  std::string args[4];
+  for (unsigned int i = 0; i < ast->num_args; i++)
+    args[i] = inline_ast(static_cast<const smtlib_smt_ast *>(ast->args[i]));
 
-  // We end with one additional brace level.
-  output = tempname;
-  return brace_level + 1;
+  return func_app_string(ast, args);
 }
 
 smt_convt::resultt
 smtlib_convt::dec_solve()
 {
+  model_values.clear();
   pre_solve();
 
   // Set some preliminaries, logic and so forth.
@@ -317,7 +376,61 @@ smtlib_convt::dec_solve()
   // check-sat
 
   fprintf(out_stream, "(check-sat)\n");
+  return read_sat_result();
+}
+
+smt_convt::resultt
+smtlib_convt::dec_solve_assuming(const ast_vec &assumptions)
+{
+  model_values.clear();
+  pre_solve();
+
+  // check-sat-assuming only takes boolean constants (or their negations), so
+  // give each assumption a name first, reusing the one from an earlier call
+  // where there is one. Like a definition, the name goes when this context
+  // is popped.
+  std::string lits;
+  for (smt_astt a : assumptions) {
+    std::stringstream ss;
+    defined_astst::iterator it = assumption_lits.find(a);
+    if (it != assumption_lits.end()) {
+      ss << temp_prefix << it->num;
+      lits += " " + ss.str();
+      continue;
+    }
+
+    std::string term;
+    emit_ast(static_cast<const smtlib_smt_ast *>(a), term);
 
+    unsigned long litnum = temp_sym_count.back()++;
+    ss << temp_prefix << litnum;
+    fprintf(out_stream, "(declare-fun %s () Bool)\n", ss.str().c_str());
+    fprintf(out_stream, "(assert (= %s %s))\n", ss.str().c_str(),
+            term.c_str());
+    lits += " " + ss.str();
+
+    defined_ast_rec rec = { a, ctx_level, litnum };
+    assumption_lits.insert(rec);
+  }
+
+  // As dec_solve_refined, but asking again under the same assumptions: a pop
+  // would take the model with it, so nothing here goes through the base
+  // implementation.
+  fprintf(out_stream, "(check-sat-assuming (%s))\n", lits.c_str());
+  resultt res = read_sat_result();
+  while (res == P_SATISFIABLE && array_api->refine_array_model()) {
+    model_values.clear();
+    pre_solve();
+    fprintf(out_stream, "(check-sat-assuming (%s))\n", lits.c_str());
+    res = read_sat_result();
+  }
+
+  return res;
+}
+
+smt_convt::resultt
+smtlib_convt::read_sat_result()
+{
   // Flush out command, starting model check
   fflush(out_stream);
 
@@ -330,55 +443,29 @@ smtlib_convt::dec_solve()
   smtlibparse(TOK_START_SAT);
 
   // This should generate on sexpr. See what it is.
+  resultt res;
   if (smtlib_output->token == TOK_KW_SAT) {
-    return smt_convt::P_SATISFIABLE;
+    res = smt_convt::P_SATISFIABLE;
   } else if (smtlib_output->token == TOK_KW_UNSAT) {
-    return smt_convt::P_UNSATISFIABLE;
+    res = smt_convt::P_UNSATISFIABLE;
   } else if (smtlib_output->token == TOK_KW_ERROR) {
     std::cerr << "SMTLIB solver returned error: \"" << smtlib_output->data
               << "\"" << std::endl;
-    return smt_convt::P_ERROR;
+    res = smt_convt::P_ERROR;
   } else {
     std::cerr << "Unrecognized check-sat output from smtlib solver"
               << std::endl;
     abort();
   }
+
+  delete smtlib_output;
+  return res;
 }
 
 expr2tc
 smtlib_convt::get_bv(const type2tc &type, smt_astt a)
 {
-  // This should always be a symbol.
-  const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast*>(a);
-  assert(sa->kind == SMT_FUNC_SYMBOL && "Non-symbol in smtlib expr get_bv()");
-  std::string name = sa->symname;
-
-  fprintf(out_stream, "(get-value (|%s|))\n", name.c_str());
-  fflush(out_stream);
-  smtlib_send_start_code = 1;
-  smtlibparse(TOK_START_VALUE);
-
-  if (smtlib_output->token == TOK_KW_ERROR) {
-    std::cerr << "Error from smtlib solver when fetching literal value: \""
-              << smtlib_output->data << "\"" << std::endl;
-    abort();
-  } else if (smtlib_output->token != 0) {
-    std::cerr << "Unrecognized response to get-value from smtlib solver"
-              << std::endl;
-  }
-
-  // Unpack our value from response list.
-  assert(smtlib_output->sexpr_list.size() == 1 && "More than one response to "
-         "get-value from smtlib solver");
-  sexpr &response = *smtlib_output->sexpr_list.begin();
-  // Now we have a valuation pair. First is the symbol
-  assert(response.sexpr_list.size() == 2 && "Expected 2 operands in "
-         "valuation_pair_list from smtlib solver");
-  std::list<sexpr>::iterator it = response.sexpr_list.begin();
-  sexpr &symname = *it++;
-  sexpr &respval = *it++;
-  assert(symname.token == TOK_SIMPLESYM && symname.data == name &&
-         "smtlib solver returned different symbol from get-value");
+  sexpr respval = get_value(a);
 
   // Attempt to read an integer.
   BigInt m;
@@ -396,8 +483,6 @@ smtlib_convt::get_bv(const type2tc &type, smt_astt a)
     m = string2integer(data, 2);
   }
 
-  delete smtlib_output;
-
   if(is_fixedbv_type(type))
   {
     fixedbvt fbv(
@@ -416,39 +501,16 @@ smtlib_convt::get_array_elem (const smt_ast *array, uint64_t index,
     const type2tc &t)
 {
 
-  // This should always be a symbol.
+  // The array may be any term, which get-value takes written out whole
   const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast*>(array);
-  assert(sa->kind == SMT_FUNC_SYMBOL && "Non-symbol in smtlib get_array_elem");
-  std::string name = sa->symname;
 
-  // XXX -- double bracing this may be a Z3 ecentricity
   unsigned long domain_width = array->sort->get_domain_width();
-  fprintf(out_stream,
-      "(get-value ((select |%s| (_ bv%" PRIu64 " %" PRIu64 "))))\n",
-      name.c_str(), index, domain_width);
-  fflush(out_stream);
-  smtlib_send_start_code = 1;
-  smtlibparse(TOK_START_VALUE);
-
-  if (smtlib_output->token == TOK_KW_ERROR) {
-    std::cerr << "Error from smtlib solver when fetching literal value: \""
-              << smtlib_output->data << "\"" << std::endl;
-    abort();
-  } else if (smtlib_output->token != 0) {
-    std::cerr << "Unrecognized response to get-value from smtlib solver"
-              << std::endl;
-  }
-
-  // Unpack our value from response list.
-  assert(smtlib_output->sexpr_list.size() == 1 && "More than one response to "
-         "get-value from smtlib solver");
-  sexpr &response = *smtlib_output->sexpr_list.begin();
-  // Now we have a valuation pair. First is the symbol
-  assert(response.sexpr_list.size() == 2 && "Expected 2 operands in "
-         "valuation_pair_list from smtlib solver");
-  std::list<sexpr>::iterator it = response.sexpr_list.begin();
-  it++; // Echo of what we selected
-  sexpr &respval = *it++;
+  std::stringstream ss;
+  ss << "(select " << inline_ast(sa) << " (_ bv" << index << " "
+     << domain_width << "))";
+  sexpr *values = query_values(std::vector<std::string>(1, ss.str()));
+  sexpr respval = values->sexpr_list.front().sexpr_list.back();
+  delete values;
 
   // Attempt to read an integer.
   BigInt m;
@@ -513,7 +575,6 @@ smtlib_convt::get_array_elem (const smt_ast *array, uint64_t index,
     abort();
   }
 
-  delete smtlib_output;
   return result;
 }
 
@@ -521,17 +582,25 @@ smtlib_convt::get_array_elem (const smt_ast *array, uint64_t index,
 expr2tc
 smtlib_convt::get_bool(smt_astt a)
 {
-  fprintf(out_stream, "(get-value (");
+  sexpr second = get_value(a);
 
-  std::string output;
-  unsigned int brace_level =
-    emit_ast(static_cast<const smtlib_smt_ast*>(a), output);
-  fprintf(out_stream, "%s", output.c_str());
+  // And finally we have our value. It should be true or false.
+  expr2tc result;
+  if (second.token == TOK_KW_TRUE) {
+    result = gen_true_expr();
+  } else if (second.token == TOK_KW_FALSE) {
+    result = gen_false_expr();
+  }
 
-  // Emit a ton of end braces.
-  for (unsigned int i = 0; i < brace_level; i++)
-    fputc(')', out_stream);
+  return result;
+}
 
+sexpr *
+smtlib_convt::query_values(const std::vector<std::string> &terms)
+{
+  fprintf(out_stream, "(get-value (");
+  for (const std::string &term : terms)
+    fprintf(out_stream, " %s", term.c_str());
   fprintf(out_stream, "))\n");
 
   fflush(out_stream);
@@ -547,32 +616,68 @@ smtlib_convt::get_bool(smt_astt a)
               << std::endl;
   }
 
-  // First layer: valuation pair list. Should have one item.
-  assert(smtlib_output->sexpr_list.size() == 1 && "Unexpected number of "
-         "responses to get-value from smtlib solver");
-  sexpr &pair = *smtlib_output->sexpr_list.begin();
-  // Should have two entries
-  assert(pair.sexpr_list.size() == 2 && "Valuation pair in smtlib get-value "
-         "output without two operands");
-  std::list<sexpr>::const_iterator it = pair.sexpr_list.begin();
-  const sexpr &first = *it++;
-  (void)first;
-  const sexpr &second = *it++;
-//  assert(first.token == TOK_SIMPLESYM && first.data == ss.str() &&
-//         "Unexpected valuation variable from smtlib solver");
-
-  // And finally we have our value. It should be true or false.
-  expr2tc result;
-  if (second.token == TOK_KW_TRUE) {
-    result = gen_true_expr();
-  } else if (second.token == TOK_KW_FALSE) {
-    result = gen_false_expr();
+  // A valuation pair list, with a (term value) pair per term, in order.
+  assert(smtlib_output->sexpr_list.size() == terms.size() &&
+         "Unexpected number of responses to get-value from smtlib solver");
+  for (const sexpr &pair : smtlib_output->sexpr_list) {
+    (void)pair;
+    assert(pair.sexpr_list.size() == 2 && "Valuation pair in smtlib "
+           "get-value output without two operands");
   }
 
-  delete smtlib_output;
+  return smtlib_output;
+}
+
+sexpr
+smtlib_convt::get_value(smt_astt a)
+{
+  std::unordered_map<smt_astt, sexpr>::const_iterator it =
+    model_values.find(a);
+  if (it != model_values.end())
+    return it->second;
+
+  std::string term = inline_ast(static_cast<const smtlib_smt_ast *>(a));
+  sexpr *values = query_values(std::vector<std::string>(1, term));
+  sexpr result = values->sexpr_list.front().sexpr_list.back();
+  delete values;
   return result;
 }
 
+void
+smtlib_convt::prefetch_values(const std::vector<smt_astt> &asts)
+{
+  // Nothing to ask if we're only writing to a file.
+  if (in_stream == nullptr)
+    return;
+
+  // One get-value for everything, rather than a round trip to the solver
+  // process for each value.
+  std::vector<smt_astt> wanted;
+  std::vector<std::string> terms;
+  for (smt_astt a : asts) {
+    const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast *>(a);
+    if (model_values.find(a) != model_values.end())
+      continue;
+
+    if (sa->sort->id != SMT_SORT_BOOL && sa->kind != SMT_FUNC_SYMBOL)
+      continue;
+
+    // Don't ask twice for the same thing
+    model_values[a] = sexpr();
+    wanted.push_back(a);
+    terms.push_back(inline_ast(sa));
+  }
+
+  if (terms.empty())
+    return;
+
+  sexpr *values = query_values(terms);
+  std::list<sexpr>::const_iterator it = values->sexpr_list.begin();
+  for (smt_astt a : wanted)
+    model_values[a] = (it++)->sexpr_list.back();
+  delete values;
+}
+
 const std::string
 smtlib_convt::solver_text()
 {
@@ -588,36 +693,21 @@ void
 smtlib_convt::assert_ast(const smt_ast *a)
 {
   const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast *>(a);
+  model_values.clear();
 
-  // Encode an assertion
-  fprintf(out_stream, "(assert\n");
-
-  // The algorithm: descend through the AST operands, binding values to
-  // temporary symbols, then emit functions on those temporary symbols.
-  // All recursively. The non-trivial bit is tracking how many ending
-  // braces are required.
-  // This is inspired by the output from Z3 that I've seen.
+  // Define everything the assertion refers to, then assert its name.
   std::string output;
-  unsigned int brace_level = emit_ast(sa, output);
-
-  // Emit the final temporary symbol - this is what gets asserted.
-  fprintf(out_stream, "%s", output.c_str());
-
-  // Emit a ton of end braces.
-  for (unsigned int i = 0; i < brace_level; i++)
-    fputc(')', out_stream);
-
-  // Final brace for closing the 'assert'.
-  fprintf(out_stream, ")\n");
+  emit_ast(sa, output);
+  fprintf(out_stream, "(assert %s)\n", output.c_str());
 }
 
 smt_ast *
-smtlib_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
-                          const smt_ast * const *args,
-                          unsigned int numargs)
+smtlib_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
+                               const smt_ast * const *args,
+                               unsigned int numargs)
 {
   assert(numargs <= 4 && "Too many arguments to smtlib mk_func_app");
-  smtlib_smt_ast *a = new smtlib_smt_ast(this, s, k);
+  smtlib_smt_ast *a = new (this) smtlib_smt_ast(this, s, k);
   a->num_args = numargs;
   for (unsigned int i = 0; i < 4; i++)
     a->args[i] = args[i];
@@ -634,10 +724,10 @@ smtlib_convt::mk_sort(const smt_sort_kind k, ...)
   va_start(ap, k);
   switch (k) {
   case SMT_SORT_INT:
-    s = new smtlib_smt_sort(k);
+    s = new (this) smtlib_smt_sort(k);
     break;
   case SMT_SORT_REAL:
-    s = new smtlib_smt_sort(k);
+    s = new (this) smtlib_smt_sort(k);
     break;
   case SMT_SORT_FIXEDBV:
   case SMT_SORT_UBV:
@@ -645,18 +735,18 @@ smtlib_convt::mk_sort(const smt_sort_kind k, ...)
   {
     unsigned long uint = va_arg(ap, unsigned long);
     assert(uint != 0);
-    s = new smtlib_smt_sort(k, uint);
+    s = new (this) smtlib_smt_sort(k, uint);
     break;
   }
   case SMT_SORT_ARRAY:
   {
     smtlib_smt_sort* dom = va_arg(ap, smtlib_smt_sort *); // Consider constness?
     smtlib_smt_sort* range = va_arg(ap, smtlib_smt_sort *);
-    s = new smtlib_smt_sort(k, dom, range);
+    s = new (this) smtlib_smt_sort(k, dom, range);
     break;
   }
   case SMT_SORT_BOOL:
-    s = new smtlib_smt_sort(k);
+    s = new (this) smtlib_smt_sort(k);
     break;
   default:
     assert(0);
@@ -669,7 +759,7 @@ smt_ast *
 smtlib_convt::mk_smt_int(const mp_integer &theint, bool sign)
 {
   smt_sortt s = mk_sort(SMT_SORT_INT, sign);
-  smtlib_smt_ast *a = new smtlib_smt_ast(this, s, SMT_FUNC_INT);
+  smtlib_smt_ast *a = new (this) smtlib_smt_ast(this, s, SMT_FUNC_INT);
   a->intval = theint;
   return a;
 }
@@ -678,7 +768,7 @@ smt_ast *
 smtlib_convt::mk_smt_real(const std::string &str)
 {
   smt_sortt s = mk_sort(SMT_SORT_REAL);
-  smtlib_smt_ast *a = new smtlib_smt_ast(this, s, SMT_FUNC_REAL);
+  smtlib_smt_ast *a = new (this) smtlib_smt_ast(this, s, SMT_FUNC_REAL);
   a->realval = str;
   return a;
 }
@@ -687,7 +777,7 @@ smt_ast *
 smtlib_convt::mk_smt_bvint(const mp_integer &theint, bool sign, unsigned int w)
 {
   smt_sortt s = mk_sort(sign ? SMT_SORT_SBV : SMT_SORT_UBV, w);
-  smtlib_smt_ast *a = new smtlib_smt_ast(this, s, SMT_FUNC_BVINT);
+  smtlib_smt_ast *a = new (this) smtlib_smt_ast(this, s, SMT_FUNC_BVINT);
   a->intval = theint;
   return a;
 }
@@ -696,7 +786,7 @@ smt_ast *
 smtlib_convt::mk_smt_bool(bool val)
 {
   smtlib_smt_ast *a =
-    new smtlib_smt_ast(this,mk_sort(SMT_SORT_BOOL), SMT_FUNC_BOOL);
+    new (this) smtlib_smt_ast(this,mk_sort(SMT_SORT_BOOL), SMT_FUNC_BOOL);
   a->boolval = val;
   return a;
 }
@@ -711,7 +801,7 @@ smtlib_convt::mk_array_symbol(const std::string &name, const smt_sort *s,
 smt_ast *
 smtlib_convt::mk_smt_symbol(const std::string &name, const smt_sort *s)
 {
-  smtlib_smt_ast *a = new smtlib_smt_ast(this, s, SMT_FUNC_SYMBOL);
+  smtlib_smt_ast *a = new (this) smtlib_smt_ast(this, s, SMT_FUNC_SYMBOL);
   a->symname = name;
 
   symbol_tablet::iterator it = symbol_table.find(name);
@@ -744,7 +834,7 @@ smt_ast *
 smtlib_convt::mk_extract(const smt_ast *a, unsigned int high, unsigned int low,
                          const smt_sort *s)
 {
-  smtlib_smt_ast *n = new smtlib_smt_ast(this, s, SMT_FUNC_EXTRACT);
+  smtlib_smt_ast *n = new (this) smtlib_smt_ast(this, s, SMT_FUNC_EXTRACT);
   n->extract_high = high;
   n->extract_low = low;
   n->num_args = 1;
@@ -765,6 +855,7 @@ smtlib_convt::push_ctx()
 {
   smt_convt::push_ctx();
   temp_sym_count.push_back(temp_sym_count.back());
+  model_values.clear();
 
   fprintf(out_stream, "(push 1)\n");
 }
@@ -777,7 +868,12 @@ smtlib_convt::pop_ctx()
   // Wipe this level of symbol table.
   symbol_tablet::nth_index<1>::type &syms_numindex = symbol_table.get<1>();
   syms_numindex.erase(ctx_level);
+  defined_astst::nth_index<1>::type &defs_numindex = defined_asts.get<1>();
+  defs_numindex.erase(ctx_level);
+  defined_astst::nth_index<1>::type &lits_numindex = assumption_lits.get<1>();
+  lits_numindex.erase(ctx_level);
   temp_sym_count.pop_back();
+  model_values.clear();
 
   smt_convt::pop_ctx();
 }
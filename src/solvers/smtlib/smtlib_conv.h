@@ -7,6 +7,7 @@
 #include <solvers/smt/smt_tuple_flat.h>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
 #include <util/irep2.h>
 
 class sexpr {
@@ -58,10 +59,12 @@ public:
   ~smtlib_convt() override;
 
   resultt dec_solve() override;
+  resultt dec_solve_assuming(const ast_vec &assumptions) override;
+  resultt read_sat_result();
   const std::string solver_text() override;
 
   void assert_ast(const smt_ast *a) override;
-  smt_ast *mk_func_app(
+  smt_ast *mk_func_app_impl(
     const smt_sort *s, 
     smt_func_kind k,
     const smt_ast * const *args,
@@ -100,10 +103,17 @@ public:
     const smt_ast *array,
     uint64_t index,
     const type2tc &type) override;
+  void prefetch_values(const std::vector<smt_astt> &asts) override;
+
+  sexpr *query_values(const std::vector<std::string> &terms);
+  sexpr get_value(smt_astt a);
 
   std::string sort_to_string(const smt_sort *s) const;
   unsigned int emit_terminal_ast(const smtlib_smt_ast *a, std::string &output);
-  unsigned int emit_ast(const smtlib_smt_ast *ast, std::string &output);
+  void emit_ast(const smtlib_smt_ast *ast, std::string &output);
+  std::string inline_ast(const smtlib_smt_ast *ast);
+  std::string func_app_string(const smtlib_smt_ast *ast,
+                              const std::string *args) const;
 
   void push_ctx() override;
   void pop_ctx() override;
@@ -139,6 +149,41 @@ public:
   > symbol_tablet;
 
   symbol_tablet symbol_table;
+
+  // Function applications already given a name with define-fun, so that each
+  // distinct AST is printed once however many times it's referred to. Like
+  // the symbol table, entries go when the context they were made in is
+  // popped; so do the solver's definitions, and perhaps the ASTs themselves.
+
+  struct defined_ast_rec {
+    const smt_ast *ast;
+    unsigned int level;
+    unsigned long num;
+  };
+
+  typedef boost::multi_index_container<
+    defined_ast_rec,
+    boost::multi_index::indexed_by<
+      boost::multi_index::hashed_unique<
+        BOOST_MULTI_INDEX_MEMBER(defined_ast_rec, const smt_ast *, ast)
+      >,
+      boost::multi_index::ordered_non_unique<
+        BOOST_MULTI_INDEX_MEMBER(defined_ast_rec, unsigned int, level),
+        std::greater<unsigned int>
+      >
+    >
+  > defined_astst;
+
+  defined_astst defined_asts;
+
+  // Boolean constants standing for assumptions passed to dec_solve_assuming,
+  // keyed the same way. The (= lit term) that names one is asserted for good,
+  // so each AST is named once per context rather than once per call.
+  defined_astst assumption_lits;
+
+  // Model values fetched in advance by prefetch_values, which are good until
+  // the formula changes or the context is pushed or popped.
+  std::unordered_map<smt_astt, sexpr> model_values;
   std::vector<unsigned long> temp_sym_count;
   static const std::string temp_prefix;
 };
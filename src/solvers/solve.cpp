@@ -1,8 +1,10 @@
 #include <solve.h>
 #include <solver_config.h>
 #include <solvers/smt/array_conv.h>
+#include <solvers/smt/fp_bv_conv.h>
 #include <solvers/smt/fp_conv.h>
 #include <solvers/smt/smt_array.h>
+#include <solvers/smt/smt_packed_ptr.h>
 #include <solvers/smt/smt_tuple.h>
 #include <solvers/smt/smt_tuple_flat.h>
 
@@ -153,20 +155,63 @@ create_solver_factory(const std::string &solver_name,
   bool node_flat = options.get_bool_option("tuple-node-flattener");
   bool sym_flat = options.get_bool_option("tuple-sym-flattener");
   bool array_flat = options.get_bool_option("array-flattener");
+  bool lazy_arrays = options.get_bool_option("lazy-arrays");
+  bool fp_to_bv = options.get_bool_option("fp2bv");
+  bool packed_ptrs = options.get_bool_option("packed-pointers");
+
+  // Lazy array axioms are only added after the solver answers sat. A formula
+  // that's written out rather than solved would go without them.
+  bool smtlib = solver_name == "smtlib" || options.get_bool_option("smtlib");
+  if (lazy_arrays &&
+      (options.get_bool_option("smt-formula-only") ||
+       options.get_bool_option("smt-formula-too") ||
+       (smtlib && options.get_option("output") != ""))) {
+    std::cerr << "Array axioms can't be added lazily to a formula that's only "
+                 "written out, encoding them eagerly" << std::endl;
+    lazy_arrays = false;
+  }
+
+  if (packed_ptrs && int_encoding) {
+    std::cerr << "Packed pointers need bitvector arithmetic, using tuples";
+    std::cerr << std::endl;
+    packed_ptrs = false;
+  }
 
   // Pick a tuple flattener to use. If the solver has native support, and no
-  // options were given, use that by default
-  if (tuple_api != nullptr && !node_flat && !sym_flat)
-    ctx->set_tuple_iface(tuple_api);
+  // options were given, use that by default. Packed pointers have to live in
+  // the members of flattened structs, so they need the node flattener.
+  tuple_iface *tuples;
+  if (tuple_api != nullptr && !node_flat && !sym_flat && !packed_ptrs)
+    tuples = tuple_api;
   // Use the node flattener if specified
-  else if (node_flat)
-    ctx->set_tuple_iface(new smt_tuple_node_flattener(ctx, ns));
+  else if (node_flat || packed_ptrs)
+    tuples = new smt_tuple_node_flattener(ctx, ns);
   // Use the symbol flattener if specified
   else if (sym_flat)
-    ctx->set_tuple_iface(new smt_tuple_sym_flattener(ctx, ns));
+    tuples = new smt_tuple_sym_flattener(ctx, ns);
   // Default: node flattener
   else
-    ctx->set_tuple_iface(new smt_tuple_node_flattener(ctx, ns));
+    tuples = new smt_tuple_node_flattener(ctx, ns);
+
+  if (packed_ptrs) {
+    // Enough object bits for every object that was counted in the formula.
+    // Under --smt-during-symex objects are encoded before they can all be
+    // counted, so there the field is as wide as a pointer.
+    unsigned int num_objs =
+      strtoul(options.get_option("pointer-objects").c_str(), nullptr, 10);
+    unsigned int obj_bits = 1;
+    if (num_objs == 0)
+      obj_bits = config.ansi_c.pointer_width;
+    while ((1ULL << obj_bits) < num_objs)
+      obj_bits++;
+
+    if (obj_bits > config.ansi_c.pointer_width)
+      obj_bits = config.ansi_c.pointer_width;
+
+    tuples = new smt_packed_ptr_flattener(ctx, tuples, obj_bits);
+  }
+
+  ctx->set_tuple_iface(tuples);
 
   // Pick an array flattener to use. Again, pick the solver native one by
   // default, or the one specified, or if none of the above then use the built
@@ -174,11 +219,15 @@ create_solver_factory(const std::string &solver_name,
   if (array_api != nullptr && !array_flat)
     ctx->set_array_iface(array_api);
   else if (array_flat)
-    ctx->set_array_iface(new array_convt(ctx));
+    ctx->set_array_iface(new array_convt(ctx, lazy_arrays));
   else
-    ctx->set_array_iface(new array_convt(ctx));
+    ctx->set_array_iface(new array_convt(ctx, lazy_arrays));
 
-  if(fp_api != NULL)
+  // Floating-point: lower it to bitvectors if asked to, otherwise use the
+  // solver's own theory, where there is one.
+  if (fp_to_bv)
+    ctx->set_fp_conv(new fp_bv_convt(ctx));
+  else if(fp_api != NULL)
     ctx->set_fp_conv(fp_api);
   else
     ctx->set_fp_conv(new fp_convt(ctx));
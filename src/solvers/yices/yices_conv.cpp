@@ -121,9 +121,9 @@ yices_convt::assert_ast(smt_astt a)
 }
 
 smt_astt
-yices_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
-                         const smt_ast * const *args,
-                         unsigned int numargs)
+yices_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
+                              const smt_ast * const *args,
+                              unsigned int numargs)
 {
   const yices_smt_ast *asts[4];
   unsigned int i;
@@ -291,15 +291,15 @@ yices_convt::mk_sort(const smt_sort_kind k, ...)
   switch(k) {
   case SMT_SORT_BOOL:
   {
-    return new yices_smt_sort(k, yices_bool_type());
+    return new (this) yices_smt_sort(k, yices_bool_type());
   }
   case SMT_SORT_INT:
   {
-    return new yices_smt_sort(k, yices_int_type(), 0);
+    return new (this) yices_smt_sort(k, yices_int_type(), 0);
   }
   case SMT_SORT_REAL:
   {
-    return new yices_smt_sort(k, yices_real_type());
+    return new (this) yices_smt_sort(k, yices_real_type());
   }
   case SMT_SORT_ARRAY:
   {
@@ -313,14 +313,14 @@ yices_convt::mk_sort(const smt_sort_kind k, ...)
     if (range->id == SMT_SORT_STRUCT || range->id == SMT_SORT_UNION)
       tmp = 1;
 
-    return new yices_smt_sort(k, t, tmp, dom->get_data_width(), range);
+    return new (this) yices_smt_sort(k, t, tmp, dom->get_data_width(), range);
   }
   case SMT_SORT_FIXEDBV:
   case SMT_SORT_UBV:
   case SMT_SORT_SBV:
   {
     unsigned long uint = va_arg(ap, unsigned long);
-    return new yices_smt_sort(k, yices_bv_type(uint), uint);
+    return new (this) yices_smt_sort(k, yices_bv_type(uint), uint);
   }
   case SMT_SORT_FLOATBV:
   {
@@ -356,7 +356,7 @@ yices_convt::mk_smt_bvint(const mp_integer &theint, bool sign, unsigned int widt
 {
   smt_sortt s = mk_sort(ctx->int_encoding ? SMT_SORT_INT : sign ? SMT_SORT_SBV : SMT_SORT_UBV, width);
   term_t term = yices_bvconst_uint64(width, theint.to_int64());
-  return new yices_smt_ast(this, s, term);
+  return new (this) yices_smt_ast(this, s, term);
 }
 
 smt_astt
@@ -384,7 +384,7 @@ yices_convt::mk_smt_symbol(const std::string &name, smt_sortt s)
       yices_set_term_name(term, name.c_str());
   }
 
-  return new yices_smt_ast(this, s, term);
+  return new (this) yices_smt_ast(this, s, term);
 }
 
 smt_astt
@@ -513,7 +513,7 @@ yices_smt_ast::project(smt_convt *ctx, unsigned int elem) const
   const struct_union_data &data = ctx->get_type_def(type);
   smt_sortt elemsort = ctx->convert_sort(data.members[elem]);
 
-  return new yices_smt_ast(ctx, elemsort, yices_select(elem + 1, term));
+  return new (ctx) yices_smt_ast(ctx, elemsort, yices_select(elem + 1, term));
 }
 
 smt_astt
@@ -529,7 +529,7 @@ yices_smt_ast::update(smt_convt *ctx, smt_astt value, unsigned int idx,
 
   const yices_smt_ast *yast = yices_ast_downcast(value);
   term_t result = yices_tuple_update(term, idx + 1, yast->term);
-  return new yices_smt_ast(ctx, sort, result);
+  return new (ctx) yices_smt_ast(ctx, sort, result);
 }
 
 smt_astt
@@ -540,7 +540,7 @@ yices_smt_ast::select(smt_convt *ctx, const expr2tc &idx) const
 
   const yices_smt_sort *ys = yices_sort_downcast(sort);
 
-  return new yices_smt_ast(
+  return new (ctx) yices_smt_ast(
     ctx, ys->rangesort, yices_application(this->term, 1, &temp_term));
 }
 
@@ -567,7 +567,7 @@ yices_convt::mk_struct_sort(const type2tc &type)
 
   // We now have an array of types, ready for sort creation
   type_t tuple_sort = yices_tuple_type(def.members.size(), sorts.data());
-  return new yices_smt_sort(SMT_SORT_STRUCT, tuple_sort, type);
+  return new (this) yices_smt_sort(SMT_SORT_STRUCT, tuple_sort, type);
 }
 
 smt_astt
@@ -593,7 +593,7 @@ yices_convt::tuple_fresh(smt_sortt s, std::string name)
   const yices_smt_sort *sort = yices_sort_downcast(s);
   term_t t = yices_new_uninterpreted_term(sort->s);
   yices_set_term_name(t, name.c_str());
-  return new yices_smt_ast(this, s, t);
+  return new (this) yices_smt_ast(this, s, t);
 }
 
 smt_astt
@@ -661,7 +661,7 @@ yices_convt::tuple_array_of(const expr2tc &init_value,
     theterm = yices_update(theterm, 1, &idxterm, yast->term);
   }
 
-  smt_sortt retsort = new yices_smt_sort(SMT_SORT_STRUCT, tuplearr);
+  smt_sortt retsort = new (this) yices_smt_sort(SMT_SORT_STRUCT, tuplearr);
   return new_ast(retsort, theterm);
 }
 
@@ -72,7 +72,7 @@ public:
 
   void assert_ast(const smt_ast *a) override;
 
-  smt_astt mk_func_app(const smt_sort *s, smt_func_kind k,
+  smt_astt mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                                const smt_ast * const *args,
                                unsigned int numargs) override;
   smt_sortt mk_sort(const smt_sort_kind k, ...) override;
@@ -127,7 +127,7 @@ public:
     const type2tc &subtype) override;
 
   inline smt_astt new_ast(smt_sortt s, term_t t) {
-    return new yices_smt_ast(this, s, t);
+    return new (this) yices_smt_ast(this, s, t);
   }
 
   inline void clear_model() {
@@ -459,9 +459,9 @@ z3_convt::mk_tuple_select(const z3::expr &t, unsigned i)
 // SMT-abstraction migration routines.
 
 smt_astt
-z3_convt::mk_func_app(const smt_sort *s, smt_func_kind k,
-                      const smt_ast * const *args,
-                      unsigned int numargs)
+z3_convt::mk_func_app_impl(const smt_sort *s, smt_func_kind k,
+                           const smt_ast * const *args,
+                           unsigned int numargs)
 {
   const z3_smt_ast *asts[4];
   unsigned int i;
@@ -876,17 +876,17 @@ z3_convt::mk_sort(const smt_sort_kind k, ...)
   va_start(ap, k);
   switch (k) {
   case SMT_SORT_INT:
-    s = new z3_smt_sort(k, z3_ctx.int_sort(), 0);
+    s = new (this) z3_smt_sort(k, z3_ctx.int_sort(), 0);
     break;
   case SMT_SORT_REAL:
-    s = new z3_smt_sort(k, z3_ctx.real_sort());
+    s = new (this) z3_smt_sort(k, z3_ctx.real_sort());
     break;
   case SMT_SORT_FIXEDBV:
   case SMT_SORT_UBV:
   case SMT_SORT_SBV:
   {
     unsigned long uint = va_arg(ap, unsigned long);
-    s = new z3_smt_sort(k, z3_ctx.bv_sort(uint), uint);
+    s = new (this) z3_smt_sort(k, z3_ctx.bv_sort(uint), uint);
     break;
   }
   case SMT_SORT_ARRAY:
@@ -901,12 +901,12 @@ z3_convt::mk_sort(const smt_sort_kind k, ...)
     if (range->id == SMT_SORT_STRUCT || range->id == SMT_SORT_BOOL || range->id == SMT_SORT_UNION)
       data_width = 1;
 
-    s = new z3_smt_sort(k, z3_ctx.array_sort(dom->s, range->s),
+    s = new (this) z3_smt_sort(k, z3_ctx.array_sort(dom->s, range->s),
                         data_width, dom->get_data_width(), range);
     break;
   }
   case SMT_SORT_BOOL:
-    s = new z3_smt_sort(k, z3_ctx.bool_sort());
+    s = new (this) z3_smt_sort(k, z3_ctx.bool_sort());
     break;
   case SMT_SORT_FLOATBV:
   {
@@ -919,7 +919,7 @@ z3_convt::mk_sort(const smt_sort_kind k, ...)
     break;
   }
   case SMT_SORT_FLOATBV_RM:
-    s = new z3_smt_sort(k, z3_ctx.fpa_rm_sort());
+    s = new (this) z3_smt_sort(k, z3_ctx.fpa_rm_sort());
     break;
   default:
     assert(0);
@@ -944,10 +944,10 @@ z3_convt::mk_struct_sort(const type2tc &type)
 
     // The '1' range is a dummy, seeing how smt_sortt has no representation of
     // tuple sort ranges
-    return new z3_smt_sort(SMT_SORT_ARRAY, s, 1, domain_width,
+    return new (this) z3_smt_sort(SMT_SORT_ARRAY, s, 1, domain_width,
                            convert_sort(arrtype.subtype));
   } else {
-    return new z3_smt_sort(SMT_SORT_STRUCT, s, type);
+    return new (this) z3_smt_sort(SMT_SORT_STRUCT, s, type);
   }
 }
 
@@ -1037,7 +1037,7 @@ z3_convt::convert_array_of(smt_astt init_val, unsigned long domain_width)
 
   size_t dom_width = (int_encoding) ? 0 : dom_sort.bv_size();
   smt_sort *s =
-    new z3_smt_sort(SMT_SORT_ARRAY, array_sort, range_width, dom_width, range);
+    new (this) z3_smt_sort(SMT_SORT_ARRAY, array_sort, range_width, dom_width, range);
   return new_ast(output, s);
 }
 
@@ -1359,7 +1359,7 @@ smt_sortt z3_convt::mk_fpbv_sort(const unsigned ew, const unsigned sw)
 {
   // We need to add an extra bit to the significand size,
   // as it has no hidden bit
-  return new z3_smt_sort(SMT_SORT_FLOATBV, z3_ctx.fpa_sort(ew, sw), ew + sw, sw);
+  return new (this) z3_smt_sort(SMT_SORT_FLOATBV, z3_ctx.fpa_sort(ew, sw), ew + sw, sw);
 }
 
 void z3_convt::dump_smt()
@@ -102,7 +102,7 @@ public:
   z3::expr mk_tuple_select(const z3::expr &t, unsigned i);
 
   // SMT-abstraction migration:
-  smt_astt mk_func_app(const smt_sort *s, smt_func_kind k,
+  smt_astt mk_func_app_impl(const smt_sort *s, smt_func_kind k,
                                const smt_ast * const *args,
                                unsigned int numargs) override;
   smt_sortt mk_sort(const smt_sort_kind k, ...) override;
@@ -189,7 +189,7 @@ public:
 
   inline z3_smt_ast *
   new_ast(z3::expr _e, const smt_sort *_s) {
-    return new z3_smt_ast(this, _e, _s);
+    return new (this) z3_smt_ast(this, _e, _s);
   }
 
   //  Must be first member; that way it's the last to be destroyed.
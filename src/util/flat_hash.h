@@ -0,0 +1,494 @@
+/*******************************************************************\
+
+Module: Open addressing hash containers
+
+\*******************************************************************/
+
+#ifndef CPROVER_FLAT_HASH_H
+#define CPROVER_FLAT_HASH_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+
+/** Hash table storing its elements in one flat array, rather than in a node
+ *  per element as std::unordered_map does. Collisions are resolved by linear
+ *  probing, and erasure shifts the rest of the probe sequence back, so there
+ *  are no tombstones. Alongside each element the table keeps its (non-zero)
+ *  hash, which spares calling Equal on most mismatches and Hash on growth.
+ *
+ *  Unlike the node-based containers, elements move: any insertion may
+ *  invalidate every reference and iterator into the table, and an erasure
+ *  those into the same cluster. Only use this where no references are held
+ *  across insertions.
+ *
+ *  Value is what's stored, KeyOfValue extracts its key. If ConstIter is set,
+ *  iterators only give const access, as with std::set.
+ */
+template <class Value, class Key, class KeyOfValue, class Hash, class Equal,
+          bool ConstIter>
+class flat_hash_tablet
+{
+public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef Hash hasher;
+  typedef Equal key_equal;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+protected:
+  template <bool IsConst>
+  class iteratort
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename flat_hash_tablet::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<IsConst, const Value *, Value *>::type
+      pointer;
+    typedef typename std::conditional<IsConst, const Value &, Value &>::type
+      reference;
+
+    iteratort() : table(nullptr), pos(0) { }
+
+    // Allow conversion from mutable to const iterators
+    template <bool B, class = typename std::enable_if<IsConst || !B>::type>
+    iteratort(const iteratort<B> &ref) : table(ref.table), pos(ref.pos) { }
+
+    reference operator*() const { return table->values[pos]; }
+    pointer operator->() const { return &table->values[pos]; }
+
+    iteratort &operator++()
+    {
+      pos = table->next_full(pos + 1);
+      return *this;
+    }
+
+    iteratort operator++(int)
+    {
+      iteratort tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    template <bool B>
+    bool operator==(const iteratort<B> &ref) const { return pos == ref.pos; }
+    template <bool B>
+    bool operator!=(const iteratort<B> &ref) const { return pos != ref.pos; }
+
+  protected:
+    typedef typename std::conditional<IsConst, const flat_hash_tablet,
+                                      flat_hash_tablet>::type tablet;
+
+    iteratort(tablet *_table, size_type _pos) : table(_table), pos(_pos) { }
+
+    tablet *table;
+    size_type pos;
+
+    friend class flat_hash_tablet;
+    template <bool> friend class iteratort;
+  };
+
+public:
+  typedef iteratort<ConstIter> iterator;
+  typedef iteratort<true> const_iterator;
+
+  flat_hash_tablet()
+    : values(nullptr), hashes(nullptr), capacity(0), num_elements(0),
+      shift(0) { }
+
+  flat_hash_tablet(const flat_hash_tablet &ref)
+    : values(nullptr), hashes(nullptr), capacity(0), num_elements(0),
+      shift(0)
+  {
+    if (ref.num_elements == 0)
+      return;
+
+    // Same size and layout as the original: no need to rehash anything.
+    allocate(ref.capacity);
+    for (size_type i = 0; i < capacity; i++) {
+      if (ref.hashes[i] != 0) {
+        new (&values[i]) Value(ref.values[i]);
+        hashes[i] = ref.hashes[i];
+        num_elements++;
+      }
+    }
+  }
+
+  flat_hash_tablet(flat_hash_tablet &&ref) noexcept
+    : values(nullptr), hashes(nullptr), capacity(0), num_elements(0),
+      shift(0)
+  {
+    swap(ref);
+  }
+
+  flat_hash_tablet &operator=(const flat_hash_tablet &ref)
+  {
+    if (this != &ref) {
+      flat_hash_tablet tmp(ref);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  flat_hash_tablet &operator=(flat_hash_tablet &&ref) noexcept
+  {
+    swap(ref);
+    return *this;
+  }
+
+  ~flat_hash_tablet()
+  {
+    clear();
+    deallocate();
+  }
+
+  iterator begin() { return iterator(this, next_full(0)); }
+  iterator end() { return iterator(this, capacity); }
+  const_iterator begin() const { return const_iterator(this, next_full(0)); }
+  const_iterator end() const { return const_iterator(this, capacity); }
+
+  bool empty() const { return num_elements == 0; }
+  size_type size() const { return num_elements; }
+
+  void clear()
+  {
+    for (size_type i = 0; i < capacity && num_elements != 0; i++) {
+      if (hashes[i] != 0) {
+        values[i].~Value();
+        hashes[i] = 0;
+        num_elements--;
+      }
+    }
+  }
+
+  void reserve(size_type n)
+  {
+    size_type cap = min_capacity;
+    while (too_full(n, cap))
+      cap *= 2;
+    if (cap > capacity)
+      rehash(cap);
+  }
+
+  void swap(flat_hash_tablet &ref) noexcept
+  {
+    std::swap(values, ref.values);
+    std::swap(hashes, ref.hashes);
+    std::swap(capacity, ref.capacity);
+    std::swap(num_elements, ref.num_elements);
+    std::swap(shift, ref.shift);
+  }
+
+  iterator find(const Key &key)
+  {
+    return iterator(this, lookup(key, hash_key(key)));
+  }
+
+  const_iterator find(const Key &key) const
+  {
+    return const_iterator(this, lookup(key, hash_key(key)));
+  }
+
+  size_type count(const Key &key) const
+  {
+    return (lookup(key, hash_key(key)) == capacity) ? 0 : 1;
+  }
+
+  std::pair<iterator, bool> insert(const Value &val)
+  {
+    const Key &key = KeyOfValue()(val);
+    size_t h = hash_key(key);
+    size_type pos = lookup(key, h);
+    if (pos != capacity)
+      return std::make_pair(iterator(this, pos), false);
+
+    pos = insert_new(h, val);
+    return std::make_pair(iterator(this, pos), true);
+  }
+
+  template <typename ...Args>
+  std::pair<iterator, bool> emplace(Args &&...args)
+  {
+    Value val(std::forward<Args>(args)...);
+    const Key &key = KeyOfValue()(val);
+    size_t h = hash_key(key);
+    size_type pos = lookup(key, h);
+    if (pos != capacity)
+      return std::make_pair(iterator(this, pos), false);
+
+    pos = insert_new(h, std::move(val));
+    return std::make_pair(iterator(this, pos), true);
+  }
+
+  size_type erase(const Key &key)
+  {
+    size_type pos = lookup(key, hash_key(key));
+    if (pos == capacity)
+      return 0;
+    erase_at(pos);
+    return 1;
+  }
+
+  /** Returns the iterator to continue from. Elements that were wrapped around
+   *  to the start of the table may shift to the end of it, and be visited a
+   *  second time. */
+  iterator erase(const_iterator it)
+  {
+    size_type pos = it.pos;
+    erase_at(pos);
+    // Something else may have been shifted into this slot
+    return iterator(this, next_full(pos));
+  }
+
+protected:
+  static const size_type min_capacity = 8;
+
+  // Keep at most three quarters of the slots in use.
+  static bool too_full(size_type n, size_type cap)
+  {
+    return n * 4 > cap * 3;
+  }
+
+  static size_t hash_key(const Key &key)
+  {
+    // Spread the bits of weak hashes (such as dstring numbers) over the top
+    // of the word, where slot indexes are taken from. Zero marks empty slots.
+    uint64_t h = static_cast<uint64_t>(Hash()(key));
+    h *= UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>(h) | 1;
+  }
+
+  size_type home(size_t h) const
+  {
+    return h >> shift;
+  }
+
+  size_type next_full(size_type pos) const
+  {
+    while (pos < capacity && hashes[pos] == 0)
+      pos++;
+    return pos;
+  }
+
+  size_type lookup(const Key &key, size_t h) const
+  {
+    if (num_elements == 0)
+      return capacity;
+
+    size_type mask = capacity - 1;
+    for (size_type pos = home(h);; pos = (pos + 1) & mask) {
+      if (hashes[pos] == 0)
+        return capacity;
+      if (hashes[pos] == h && Equal()(KeyOfValue()(values[pos]), key))
+        return pos;
+    }
+  }
+
+  template <typename V>
+  size_type insert_new(size_t h, V &&val)
+  {
+    if (capacity == 0 || too_full(num_elements + 1, capacity))
+      rehash(capacity == 0 ? min_capacity : capacity * 2);
+
+    size_type mask = capacity - 1;
+    size_type pos = home(h);
+    while (hashes[pos] != 0)
+      pos = (pos + 1) & mask;
+
+    new (&values[pos]) Value(std::forward<V>(val));
+    hashes[pos] = h;
+    num_elements++;
+    return pos;
+  }
+
+  void erase_at(size_type pos)
+  {
+    assert(pos < capacity && hashes[pos] != 0);
+    values[pos].~Value();
+    hashes[pos] = 0;
+    num_elements--;
+
+    // Shift back anything later in the cluster that may no longer be
+    // reachable from its home slot across the hole.
+    size_type mask = capacity - 1;
+    size_type hole = pos;
+    for (size_type next = (hole + 1) & mask; hashes[next] != 0;
+         next = (next + 1) & mask) {
+      size_type h = home(hashes[next]);
+      bool movable = (hole <= next) ? (h <= hole || h > next)
+                                    : (h <= hole && h > next);
+      if (!movable)
+        continue;
+
+      new (&values[hole]) Value(std::move(values[next]));
+      hashes[hole] = hashes[next];
+      values[next].~Value();
+      hashes[next] = 0;
+      hole = next;
+    }
+  }
+
+  void allocate(size_type cap)
+  {
+    values = static_cast<Value *>(::operator new(cap * sizeof(Value)));
+    hashes = new size_t[cap]();
+    capacity = cap;
+    shift = sizeof(size_t) * 8;
+    while (cap > 1) {
+      cap /= 2;
+      shift--;
+    }
+  }
+
+  void deallocate()
+  {
+    ::operator delete(values);
+    delete[] hashes;
+    values = nullptr;
+    hashes = nullptr;
+    capacity = 0;
+    shift = 0;
+  }
+
+  void rehash(size_type cap)
+  {
+    Value *old_values = values;
+    size_t *old_hashes = hashes;
+    size_type old_capacity = capacity;
+
+    allocate(cap);
+    size_type mask = capacity - 1;
+    for (size_type i = 0; i < old_capacity; i++) {
+      if (old_hashes[i] == 0)
+        continue;
+
+      size_type pos = home(old_hashes[i]);
+      while (hashes[pos] != 0)
+        pos = (pos + 1) & mask;
+
+      new (&values[pos]) Value(std::move(old_values[i]));
+      hashes[pos] = old_hashes[i];
+      old_values[i].~Value();
+    }
+
+    ::operator delete(old_values);
+    delete[] old_hashes;
+  }
+
+  Value *values;
+  size_t *hashes;
+  size_type capacity;
+  size_type num_elements;
+  unsigned int shift; // Slot indexes are the top bits of the hash
+};
+
+template <class Key, class T>
+struct flat_hash_select1st
+{
+  const Key &operator()(const std::pair<const Key, T> &v) const
+  {
+    return v.first;
+  }
+};
+
+template <class Key>
+struct flat_hash_identity
+{
+  const Key &operator()(const Key &v) const
+  {
+    return v;
+  }
+};
+
+/** Flat replacement for std::unordered_map; see flat_hash_tablet. */
+template <class Key, class T, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key> >
+class flat_hash_mapt
+  : public flat_hash_tablet<std::pair<const Key, T>, Key,
+                            flat_hash_select1st<Key, T>, Hash, Equal, false>
+{
+  typedef flat_hash_tablet<std::pair<const Key, T>, Key,
+                           flat_hash_select1st<Key, T>, Hash, Equal, false>
+    tablet;
+
+public:
+  typedef T mapped_type;
+  typedef typename tablet::iterator iterator;
+  typedef typename tablet::const_iterator const_iterator;
+
+  T &operator[](const Key &key)
+  {
+    size_t h = tablet::hash_key(key);
+    typename tablet::size_type pos = tablet::lookup(key, h);
+    if (pos == tablet::capacity)
+      pos = tablet::insert_new(h, std::pair<const Key, T>(key, T()));
+    return tablet::values[pos].second;
+  }
+
+  bool operator==(const flat_hash_mapt &ref) const
+  {
+    if (tablet::size() != ref.size())
+      return false;
+
+    for (const auto &v : *this) {
+      const_iterator it = ref.find(v.first);
+      if (it == ref.end() || !(it->second == v.second))
+        return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const flat_hash_mapt &ref) const
+  {
+    return !(*this == ref);
+  }
+
+  // boost.python's map_indexing_suite wants a key_comp(); as with
+  // esbmc_map_wrapper in hash_cont.h, it's only used for its own purposes.
+  class key_compare {
+  public:
+    bool operator()(const Key &a, const Key &b) {
+      return a < b;
+    }
+  };
+  key_compare key_comp() const
+  {
+    return key_compare();
+  }
+};
+
+/** Flat replacement for std::unordered_set; see flat_hash_tablet. */
+template <class Key, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key> >
+class flat_hash_sett
+  : public flat_hash_tablet<Key, Key, flat_hash_identity<Key>, Hash, Equal,
+                            true>
+{
+  typedef flat_hash_tablet<Key, Key, flat_hash_identity<Key>, Hash, Equal,
+                           true> tablet;
+
+public:
+  bool operator==(const flat_hash_sett &ref) const
+  {
+    if (tablet::size() != ref.size())
+      return false;
+
+    for (const auto &v : *this)
+      if (ref.count(v) == 0)
+        return false;
+    return true;
+  }
+
+  bool operator!=(const flat_hash_sett &ref) const
+  {
+    return !(*this == ref);
+  }
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*******************************************************************\
+
+Module: Flat map for small associative containers
+
+\*******************************************************************/
+
+#ifndef CPROVER_FLAT_MAP_H
+#define CPROVER_FLAT_MAP_H
+
+#include <algorithm>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+/** Map for a handful of entries, stored without a node per entry.
+ *  Entries are constructed in place in a chain of slabs, each twice the size
+ *  of the previous one, and a vector of pointers to them is kept sorted by
+ *  key. A map built by copying another takes two allocations in total, rather
+ *  than one per entry; lookups are a binary search over that vector.
+ *
+ *  Entries never move once created, so, as with std::map, a reference to one
+ *  stays valid until it's erased, whatever else is inserted. Iterators are
+ *  positions in the sorted vector though, and are invalidated by any insertion
+ *  or erasure. Iteration order is that of Compare.
+ */
+template <class Key, class T, class Compare = std::less<Key> >
+class flat_mapt
+{
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair<const Key, T> value_type;
+  typedef std::size_t size_type;
+
+protected:
+  typedef std::vector<value_type *> indext;
+
+public:
+  typedef boost::indirect_iterator<typename indext::iterator> iterator;
+  typedef boost::indirect_iterator<typename indext::const_iterator,
+                                   const value_type> const_iterator;
+
+  flat_mapt() : slabs(nullptr), free_slots(nullptr) { }
+
+  flat_mapt(const flat_mapt &ref) : slabs(nullptr), free_slots(nullptr)
+  {
+    if (ref.empty())
+      return;
+
+    // Size everything exactly: the copy is likely to stay as it is.
+    new_slab(ref.size());
+    index.reserve(ref.size());
+    for (const value_type *v : ref.index)
+      index.push_back(new (alloc_slot()) value_type(*v));
+  }
+
+  flat_mapt &operator=(const flat_mapt &ref)
+  {
+    if (this != &ref) {
+      flat_mapt tmp(ref);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ~flat_mapt()
+  {
+    clear();
+  }
+
+  iterator begin() { return iterator(index.begin()); }
+  iterator end() { return iterator(index.end()); }
+  const_iterator begin() const { return const_iterator(index.begin()); }
+  const_iterator end() const { return const_iterator(index.end()); }
+
+  bool empty() const { return index.empty(); }
+  size_type size() const { return index.size(); }
+
+  void clear()
+  {
+    for (value_type *v : index)
+      v->~value_type();
+    index.clear();
+
+    while (slabs != nullptr) {
+      slabt *next = slabs->next;
+      ::operator delete(slabs);
+      slabs = next;
+    }
+    free_slots = nullptr;
+  }
+
+  void swap(flat_mapt &ref)
+  {
+    index.swap(ref.index);
+    std::swap(slabs, ref.slabs);
+    std::swap(free_slots, ref.free_slots);
+  }
+
+  iterator find(const Key &key)
+  {
+    typename indext::iterator it = lower_bound(key);
+    if (it == index.end() || Compare()(key, (*it)->first))
+      return end();
+    return iterator(it);
+  }
+
+  const_iterator find(const Key &key) const
+  {
+    typename indext::const_iterator it = lower_bound(key);
+    if (it == index.end() || Compare()(key, (*it)->first))
+      return end();
+    return const_iterator(it);
+  }
+
+  size_type count(const Key &key) const
+  {
+    return (find(key) == end()) ? 0 : 1;
+  }
+
+  T &operator[](const Key &key)
+  {
+    typename indext::iterator it = lower_bound(key);
+    if (it != index.end() && !Compare()(key, (*it)->first))
+      return (*it)->second;
+
+    value_type *v = new (alloc_slot()) value_type(key, T());
+    index.insert(it, v);
+    return v->second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &val)
+  {
+    typename indext::iterator it = lower_bound(val.first);
+    if (it != index.end() && !Compare()(val.first, (*it)->first))
+      return std::make_pair(iterator(it), false);
+
+    value_type *v = new (alloc_slot()) value_type(val);
+    return std::make_pair(iterator(index.insert(it, v)), true);
+  }
+
+  iterator erase(iterator pos)
+  {
+    value_type *v = *pos.base();
+    v->~value_type();
+    free_slot(v);
+    return iterator(index.erase(pos.base()));
+  }
+
+  size_type erase(const Key &key)
+  {
+    iterator it = find(key);
+    if (it == end())
+      return 0;
+    erase(it);
+    return 1;
+  }
+
+  bool operator==(const flat_mapt &ref) const
+  {
+    return size() == ref.size() && std::equal(begin(), end(), ref.begin());
+  }
+
+  bool operator!=(const flat_mapt &ref) const
+  {
+    return !(*this == ref);
+  }
+
+  bool operator<(const flat_mapt &ref) const
+  {
+    return std::lexicographical_compare(begin(), end(),
+                                        ref.begin(), ref.end());
+  }
+
+protected:
+  /** Header of a block of entry slots; the slots follow it in memory. */
+  struct slabt
+  {
+    slabt *next;
+    size_type capacity;
+    size_type used;
+  };
+
+  static const size_type min_slab_capacity = 4;
+
+  static size_type slots_offset()
+  {
+    size_type align = alignof(value_type);
+    return (sizeof(slabt) + align - 1) / align * align;
+  }
+
+  static value_type *slot(slabt *slab, size_type n)
+  {
+    char *base = reinterpret_cast<char *>(slab) + slots_offset();
+    return reinterpret_cast<value_type *>(base) + n;
+  }
+
+  void new_slab(size_type capacity)
+  {
+    void *mem = ::operator new(slots_offset() + capacity * sizeof(value_type));
+    slabt *slab = static_cast<slabt *>(mem);
+    slab->next = slabs;
+    slab->capacity = capacity;
+    slab->used = 0;
+    slabs = slab;
+  }
+
+  void *alloc_slot()
+  {
+    if (free_slots != nullptr) {
+      void *res = free_slots;
+      free_slots = *static_cast<void **>(res);
+      return res;
+    }
+
+    if (slabs == nullptr)
+      new_slab(min_slab_capacity);
+    else if (slabs->used == slabs->capacity)
+      new_slab(slabs->capacity * 2);
+
+    return slot(slabs, slabs->used++);
+  }
+
+  void free_slot(void *ptr)
+  {
+    // Erased slots are chained through their first word until reused
+    static_assert(sizeof(value_type) >= sizeof(void *), "Slot too small");
+    *static_cast<void **>(ptr) = free_slots;
+    free_slots = ptr;
+  }
+
+  struct key_less
+  {
+    bool operator()(const value_type *a, const Key &b) const
+    {
+      return Compare()(a->first, b);
+    }
+  };
+
+  typename indext::iterator lower_bound(const Key &key)
+  {
+    return std::lower_bound(index.begin(), index.end(), key, key_less());
+  }
+
+  typename indext::const_iterator lower_bound(const Key &key) const
+  {
+    return std::lower_bound(index.begin(), index.end(), key, key_less());
+  }
+
+  indext index;
+  slabt *slabs;
+  void *free_slots;
+};
+
+#endif
@@ -216,6 +216,14 @@ void guardt::swap(guardt& g)
   g_expr.swap(g.g_expr);
 }
 
+void guardt::set_literal(const expr2tc &sym)
+{
+  // Only a conjunction has an expression of its own; later calls to add
+  // will conjoin to sym
+  assert(guard_list.size() > 1);
+  g_expr = sym;
+}
+
 bool guardt::is_true() const
 {
   return guard_list.empty();
@@ -33,11 +33,15 @@ public:
 
   bool is_true() const;
   bool is_false() const;
+  bool is_single_symbol() const;
 
   void make_true();
   void make_false();
   void swap(guardt &g);
 
+  // Use sym, which must equal the conjunction of the guard, as its expression
+  void set_literal(const expr2tc &sym);
+
   friend guardt &operator -= (guardt &g1, const guardt &g2);
   friend guardt &operator |= (guardt &g1, const guardt &g2);
   friend bool operator == (const guardt &g1, const guardt &g2);
@@ -48,7 +52,6 @@ protected:
   guard_listt guard_list;
   expr2tc g_expr;
 
-  bool is_single_symbol() const;
   void clear();
   void clear_append(const guardt &guard);
   void clear_insert(const expr2tc &expr);
@@ -117,4 +117,12 @@ public:
 #endif
 #endif
 
+// Open addressing tables, for where elements needn't stay put on insertion;
+// see flat_hash.h. These are the same whichever option is picked above.
+
+#include <util/flat_hash.h>
+
+#define flat_hash_map_cont flat_hash_mapt
+#define flat_hash_set_cont flat_hash_sett
+
 #endif
@@ -0,0 +1,91 @@
+/*******************************************************************\
+
+Module: Microbenchmark of hash_map_cont against flat_hash_map_cont
+
+Not built by default: run "make hash_cont_bench" in util/.
+
+\*******************************************************************/
+
+#include <cstdlib>
+#include <goto-symex/renaming.h>
+#include <iostream>
+#include <string>
+#include <util/dstring.h>
+#include <util/hash_cont.h>
+#include <util/i2string.h>
+#include <util/irep2_utils.h>
+#include <util/time_stopping.h>
+#include <vector>
+
+template <class mapt, class keyt>
+void run(const char *what, const std::vector<keyt> &keys, unsigned rounds)
+{
+  fine_timet start = current_time();
+  unsigned long sum = 0;
+
+  for (unsigned r = 0; r < rounds; r++) {
+    mapt map;
+    for (unsigned i = 0; i < keys.size(); i++)
+      map[keys[i]] = i;
+
+    // Mostly lookups, as in renaming; then a copy, as at a state fork.
+    for (unsigned j = 0; j < 8; j++)
+      for (const keyt &k : keys)
+        sum += map.find(k)->second;
+
+    mapt copy(map);
+    for (unsigned i = 0; i < keys.size(); i += 2)
+      copy.erase(keys[i]);
+    sum += copy.size();
+  }
+
+  std::cout << what << ": ";
+  output_time(current_time() - start, std::cout);
+  std::cout << "s (" << sum << ")" << std::endl;
+}
+
+template <class keyt, class hasht>
+void run_both(const char *what, const std::vector<keyt> &keys, unsigned rounds)
+{
+  std::cout << what << ", " << keys.size() << " keys" << std::endl;
+  run<hash_map_cont<keyt, unsigned, hasht> >("  hash_map_cont     ", keys,
+                                              rounds);
+  run<flat_hash_map_cont<keyt, unsigned, hasht> >("  flat_hash_map_cont", keys,
+                                                   rounds);
+}
+
+int main(int argc, const char **argv)
+{
+  unsigned n = (argc > 1) ? atoi(argv[1]) : 10000;
+  unsigned rounds = (argc > 2) ? atoi(argv[2]) : 100;
+
+  // The keys below are built from pooled types, as in esbmc/main.cpp
+  type_poolt bees(true);
+  type_pool = bees;
+
+  std::vector<dstring> names;
+  std::vector<std::string> strings;
+  std::vector<renaming::level2t::name_record> name_keys;
+  std::vector<expr2tc> exprs;
+  for (unsigned i = 0; i < n; i++) {
+    std::string s = "c::main::1::var" + i2string(i);
+    strings.push_back(s);
+    names.push_back(dstring(s));
+
+    // As level2 renaming sees them: several level1 instances and threads of
+    // the one variable, and the symbols and terms built from them.
+    expr2tc sym = symbol2tc(get_uint32_type(), names.back(), symbol2t::level2,
+                            i % 3, i / 3, i % 2, i % 7);
+    name_keys.push_back(renaming::level2t::name_record(to_symbol2t(sym)));
+    exprs.push_back(i % 2 ? sym : add2tc(sym->type, sym, gen_ulong(i % 5)));
+  }
+
+  run_both<dstring, dstring_hash>("dstring", names, rounds);
+  run_both<std::string, std::hash<std::string> >("std::string", strings,
+                                                 rounds);
+  run_both<renaming::level2t::name_record, renaming::level2t::name_rec_hash>(
+    "level2 name record", name_keys, rounds);
+  run_both<expr2tc, irep2_hash>("expr2tc", exprs, rounds);
+
+  return 0;
+}
@@ -19,6 +19,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define SHARING
 
 #include <util/dstring.h>
+#include <util/flat_map.h>
 
 typedef dstring irep_idt;
 typedef dstring irep_namet;
@@ -50,7 +51,9 @@ public:
   typedef std::vector<irept> subt;
   //typedef std::list<irept> subt;
 
-  typedef std::map<irep_namet, irept> named_subt;
+  // Named subs are usually few, and are copied wholesale whenever a shared
+  // irep is detached: keep them in one block rather than a tree of nodes.
+  typedef flat_mapt<irep_namet, irept> named_subt;
 
   // Dump contents of irep to stdout. Debugging only.
   void dump() const;
@@ -917,6 +920,18 @@ public:
   size_t hash() const;
   size_t full_hash() const;
 
+  /** Identity of the storage behind this irep. Ireps with the same identity
+   *  are equal, comments included; and as nothing modifies shared storage in
+   *  place, that holds for as long as some irept keeps the storage alive. */
+  const void *identity() const
+  {
+    #ifdef SHARING
+    return data;
+    #else
+    return &data;
+    #endif
+  }
+
   friend bool full_eq(const irept &a, const irept &b);
 
   std::string pretty(unsigned indent=0) const;
@@ -1,6 +1,9 @@
 #include <ac_config.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
 #include <util/fixedbv.h>
 #include <util/i2string.h>
 #include <util/ieee_float.h>
@@ -21,7 +24,7 @@
 // the pointer ownership model that boost.python expects. Specifically: it
 // either stores values by value, or by _boost_ shared ptrs. The former isn't
 // compatible with our irep model (everything must be held by one of our own
-// std::shared_ptrs), and the latter requires a large number of hoops to be
+// irep_containers), and the latter requires a large number of hoops to be
 // jumped through which will only really work with boost::shared_ptr's. To
 // get around this, we hack it, in what's actually a safe way.
 //
@@ -47,7 +50,7 @@
 // boost.python, because none of the irep constructors are exposed to it, so
 // it never stores an irep by value. Because objects are always in containers,
 // there's no need to worry about the lifetime of a python instance: it'll just
-// decrement the shared_ptr ref count when it gets destroyed.
+// decrement the containers ref count when it gets destroyed.
 //
 // To impose this policy upon boost.python, we register a to irep2t converter
 // that sucks the corresponding container out of the python instance, and then
@@ -201,10 +204,29 @@ get_type_id(const type2t &type)
 
 type2t::type2t(type_ids id)
   : type_id(id),
+    interned(false),
+    ref_count(0),
     crc_val(0)
 {
 }
 
+type2t::type2t(const type2t &ref)
+  : type_id(ref.type_id),
+    interned(false),
+    ref_count(0),
+    crc_val(ref.crc_val.load(std::memory_order_relaxed))
+{
+}
+
+type2t &
+type2t::operator=(const type2t &ref)
+{
+  type_id = ref.type_id;
+  crc_val.store(ref.crc_val.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+  return *this;
+}
+
 bool
 type2t::operator==(const type2t &ref) const
 {
@@ -284,8 +306,10 @@ type2t::crc() const
 size_t
 type2t::do_crc() const
 {
-  boost::hash_combine(this->crc_val, (uint8_t)type_id);
-  return this->crc_val;
+  size_t crc = 0;
+  boost::hash_combine(crc, (uint8_t)type_id);
+  crc_val.store(crc, std::memory_order_relaxed);
+  return crc;
 }
 
 void
@@ -534,15 +558,18 @@ type2t_traits<Args...>::make_contained(typename Args::result_type... args) -> ir
 /*************************** Base expr2t definitions **************************/
 
 expr2t::expr2t(const type2tc& _type, expr_ids id)
-  : std::enable_shared_from_this<expr2t>(), expr_id(id), type(_type), crc_val(0)
+  : expr_id(id), interned(false), simplified(false), ref_count(0),
+    type(_type), crc_val(0)
 {
 }
 
 expr2t::expr2t(const expr2t &ref)
-  : std::enable_shared_from_this<expr2t>(),
-    expr_id(ref.expr_id),
+  : expr_id(ref.expr_id),
+    interned(false),
+    simplified(bool(ref.simplified)),
+    ref_count(0),
     type(ref.type),
-    crc_val(ref.crc_val)
+    crc_val(ref.crc_val.load(std::memory_order_relaxed))
 {
 }
 
@@ -648,9 +675,11 @@ expr2t::crc() const
 size_t
 expr2t::do_crc() const
 {
-  boost::hash_combine(this->crc_val, type->do_crc());
-  boost::hash_combine(this->crc_val, (uint8_t)expr_id);
-  return this->crc_val;
+  size_t crc = 0;
+  boost::hash_combine(crc, type->do_crc());
+  boost::hash_combine(crc, (uint8_t)expr_id);
+  crc_val.store(crc, std::memory_order_relaxed);
+  return crc;
 }
 
 void
@@ -665,18 +694,26 @@ expr2t::hash(crypto_hash &hash) const
 expr2tc
 expr2t::simplify() const
 {
+  // We've been here before, and there was nothing to be done.
+  if (simplified)
+    return expr2tc();
+
   try {
 
   // Corner case! Don't even try to simplify address of's operands, might end up
   // taking the address of some /completely/ arbitary pice of data, by
   // simplifiying an index to its data, discarding the symbol.
-  if (__builtin_expect((expr_id == address_of_id), 0)) // unlikely
+  if (__builtin_expect((expr_id == address_of_id), 0)) { // unlikely
+    simplified = true;
     return expr2tc();
+  }
 
   // And overflows too. We don't wish an add to distribute itself, for example,
   // when we're trying to work out whether or not it's going to overflow.
-  if (__builtin_expect((expr_id == overflow_id), 0))
+  if (__builtin_expect((expr_id == overflow_id), 0)) {
+    simplified = true;
     return expr2tc();
+  }
 
   // Try initial simplification
   expr2tc res = do_simplify();
@@ -684,7 +721,7 @@ expr2t::simplify() const
     // Woot, we simplified some of this. It may have _additional_ fields that
     // need to get simplified (member2ts in arrays for example), so invoke the
     // simplifier again, to hit those potential subfields.
-    expr2tc res2 = res->simplify();
+    expr2tc res2 = res.simplify();
 
     // If we simplified even further, return res2; otherwise res.
     if (is_nil_expr(res2))
@@ -710,12 +747,16 @@ expr2t::simplify() const
     newoperands.push_back(tmp);
   }
 
-  if (changed == false)
+  if (changed == false) {
     // Second shot at simplification. For efficiency, a simplifier may be
     // holding something back until it's certain all its operands are
     // simplified. It's responsible for simplifying further if it's made that
     // call though.
-    return do_simplify(true);
+    res = do_simplify(true);
+    if (is_nil_expr(res))
+      simplified = true;
+    return res;
+  }
 
   // An operand has been changed; clone ourselves and update.
   expr2tc new_us = clone();
@@ -741,10 +782,55 @@ expr2t::simplify() const
     // being a dynamically sized array somewhere in there. In this circumstance,
     // don't even attempt partial simpilfication. We'd probably have to double
     // the size of simplification code in that case.
+    simplified = true;
     return expr2tc();
   }
 }
 
+// Results of simplifying non-leaf exprs, nil meaning nothing to be done. Keys
+// hold a reference to their expr, so they can't be freed (and their address
+// reused) or modified in place while they're in here. Once it's full, or once
+// a phase is over (see simplify_memo_clear), the memo is simply flushed. Each
+// thread keeps its own.
+#ifdef THREAD_SAFE_IREP
+thread_local
+#endif
+static std::unordered_map<expr2tc, expr2tc, irep2_hash> simplify_memo;
+static const size_t simplify_memo_limit = 1 << 18;
+
+expr2tc
+simplify_memoized(const expr2tc &expr)
+{
+  const expr2t *e = expr.get();
+  if (e->simplified)
+    return expr2tc();
+
+  // Leaves are quicker to simplify than to look up.
+  if (e->get_num_sub_exprs() == 0)
+    return e->simplify();
+
+  auto it = simplify_memo.find(expr);
+  if (it != simplify_memo.end()) {
+    if (is_nil_expr(it->second))
+      e->simplified = true;
+    return it->second;
+  }
+
+  expr2tc res = e->simplify();
+
+  if (simplify_memo.size() >= simplify_memo_limit)
+    simplify_memo.clear();
+  simplify_memo.emplace(expr, res);
+  return res;
+}
+
+void
+simplify_memo_clear()
+{
+  // Swapped out rather than cleared, so the buckets are freed too
+  std::unordered_map<expr2tc, expr2tc, irep2_hash>().swap(simplify_memo);
+}
+
 static const char *expr_names[] = {
   "constant_int",
   "constant_fixedbv",
@@ -1186,6 +1272,9 @@ type_poolt::operator=(type_poolt const &ref)
   string_map = ref.string_map;
   code_map = ref.code_map;
 
+  // Entries point into the maps of the pool being copied
+  identity_map.clear();
+
   // Re-establish some pointers
   uint8 = &unsignedbv_map[unsignedbv_typet(8)];
   uint16 = &unsignedbv_map[unsignedbv_typet(16)];
@@ -1199,24 +1288,29 @@ type_poolt::operator=(type_poolt const &ref)
   return *this;
 }
 
-// XXX investigate performance implications of this cache
-static const type2tc &
-get_type_from_pool(const typet &val,
-    std::map<typet, type2tc> &map __attribute__((unused)))
+const type2tc &
+type_poolt::get_type_from_pool(const typet &val, type_mapt &map)
 {
-#if 0
-  std::map<const typet, type2tc>::const_iterator it = map.find(val);
-  if (it != map.end())
-    return it->second;
+#ifdef THREAD_SAFE_IREP
+  // Migration of subtypes comes back in here, hence a recursive lock.
+  std::lock_guard<std::recursive_mutex> guard(lock);
 #endif
+  identity_mapt::const_iterator id_it = identity_map.find(val.identity());
+  if (id_it != identity_map.end())
+    return *id_it->second.second;
+
+  type_mapt::iterator it = map.find(val);
+  if (it == map.end()) {
+    type2tc new_type;
+    real_migrate_type(val, new_type);
+    // Migrating subtypes may have added to the map: look it up afresh.
+    it = map.emplace(val, new_type).first;
+  }
 
-  type2tc new_type;
-  real_migrate_type(val, new_type);
-#if 0
-  map[val] = new_type;
-  return map[val];
-#endif
-  return *(new type2tc(new_type));
+  if (identity_map.size() >= identity_map_limit)
+    identity_map.clear();
+  identity_map.emplace(val.identity(), std::make_pair(val, &it->second));
+  return it->second;
 }
 
 const type2tc &
@@ -1321,6 +1415,289 @@ type_poolt::get_int(unsigned int size)
 
 type_poolt type_pool;
 
+/***************************** Node allocation *******************************/
+
+/** Free lists of irep nodes, one per size class. Classes are a granule apart,
+ *  which keeps every block suitably aligned for any irep member; a list that
+ *  runs dry is refilled by carving up a fresh chunk. Nothing in here has a
+ *  constructor or destructor, so nodes can be freed during static destruction
+ *  without worrying about ordering. The per kind pools (irep_kind_poolt) are
+ *  carved up the same way, and fall back on these for odd sizes. */
+class irep_node_poolt
+{
+public:
+  void *alloc(size_t size)
+  {
+    if (size > max_block_size)
+      return ::operator new(size);
+
+    unsigned int cls = size_class(size);
+    free_blockt *block = free_lists[cls];
+    if (block == nullptr)
+      block = refill(cls);
+
+    free_lists[cls] = block->next;
+    return block;
+  }
+
+  void free(void *ptr, size_t size)
+  {
+    if (ptr == nullptr)
+      return;
+
+    if (size > max_block_size) {
+      ::operator delete(ptr);
+      return;
+    }
+
+    unsigned int cls = size_class(size);
+    free_blockt *block = static_cast<free_blockt *>(ptr);
+    block->next = free_lists[cls];
+    free_lists[cls] = block;
+  }
+
+  static void *kind_alloc(irep_kind_poolt &pool, size_t size)
+  {
+    // Kinds are numerous and some are rare, so they're refilled in smaller
+    // chunks than the size classes.
+    free_blockt *block = static_cast<free_blockt *>(pool.free_list);
+    if (block == nullptr)
+      block = carve((size_class(size) + 1) * granule, kind_chunk_size);
+
+    pool.free_list = block->next;
+    return block;
+  }
+
+  static void kind_free(irep_kind_poolt &pool, void *ptr)
+  {
+    free_blockt *block = static_cast<free_blockt *>(ptr);
+    block->next = static_cast<free_blockt *>(pool.free_list);
+    pool.free_list = block;
+  }
+
+  static const size_t max_block_size = 512;
+
+protected:
+  struct free_blockt
+  {
+    free_blockt *next;
+  };
+
+  static const size_t granule = alignof(std::max_align_t);
+  static const size_t chunk_size = 64 * 1024;
+  static const size_t kind_chunk_size = 16 * 1024;
+  static const unsigned int num_classes = max_block_size / granule;
+
+  static unsigned int size_class(size_t size)
+  {
+    assert(size != 0);
+    return (size - 1) / granule;
+  }
+
+  free_blockt *refill(unsigned int cls)
+  {
+    return carve((cls + 1) * granule, chunk_size);
+  }
+
+  static free_blockt *carve(size_t block_size, size_t size)
+  {
+    size_t num_blocks = size / block_size;
+    char *chunk = static_cast<char *>(::operator new(size));
+
+    for (size_t i = 0; i < num_blocks - 1; i++)
+      reinterpret_cast<free_blockt *>(chunk + i * block_size)->next =
+        reinterpret_cast<free_blockt *>(chunk + (i + 1) * block_size);
+    reinterpret_cast<free_blockt *>(chunk + (num_blocks - 1) * block_size)
+      ->next = nullptr;
+
+    return reinterpret_cast<free_blockt *>(chunk);
+  }
+
+  free_blockt *free_lists[num_classes];
+};
+
+// With THREAD_SAFE_IREP, threads each allocate from their own pool. A node
+// freed by a thread other than the one that allocated it simply joins the
+// freeing thread's free list.
+#ifdef THREAD_SAFE_IREP
+thread_local
+#endif
+static irep_node_poolt irep_node_pool;
+
+void *
+irep_pool_alloc(size_t size)
+{
+  return irep_node_pool.alloc(size);
+}
+
+void
+irep_pool_free(void *ptr, size_t size)
+{
+  irep_node_pool.free(ptr, size);
+}
+
+void *
+irep_pool_alloc(irep_kind_poolt &pool, size_t kind_size, size_t size)
+{
+  if (size != kind_size || size > irep_node_poolt::max_block_size)
+    return irep_node_pool.alloc(size);
+
+  return irep_node_poolt::kind_alloc(pool, size);
+}
+
+void
+irep_pool_free(irep_kind_poolt &pool, size_t kind_size, void *ptr,
+               size_t size)
+{
+  if (ptr == nullptr)
+    return;
+
+  if (size != kind_size || size > irep_node_poolt::max_block_size) {
+    irep_node_pool.free(ptr, size);
+    return;
+  }
+
+  irep_node_poolt::kind_free(pool, ptr);
+}
+
+/****************************** Hash consing *********************************/
+
+bool irep_hash_consing = false;
+
+/** Unique table mapping irep hashes to the canonical node with that content.
+ *  Entries don't hold a reference: a canonical node removes itself from the
+ *  table when its last container releases it, or when it's about to be
+ *  modified in place. */
+template <class T>
+class irep_unique_tablet
+{
+public:
+  irep_container<T> intern(const irep_container<T> &ref)
+  {
+    size_t hash = ref.crc();
+#ifdef THREAD_SAFE_IREP
+    std::lock_guard<std::mutex> guard(lock);
+#endif
+    auto range = table.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+      if (*it->second == *ref && acquire_live(it->second)) {
+        irep_container<T> res(it->second);
+        it->second->ref_count--; // Drop the one acquire_live took
+        return res;
+      }
+    }
+
+    // Mark the node as canonical directly: anyone else sharing it is about
+    // to hold the canonical copy too.
+    const_cast<T *>(ref.get())->interned = true;
+    table.emplace(hash, ref.get());
+    return ref;
+  }
+
+  void release(const T *node)
+  {
+#ifdef THREAD_SAFE_IREP
+    std::lock_guard<std::mutex> guard(lock);
+#endif
+    size_t hash = node->crc_val.load(std::memory_order_relaxed);
+    auto range = table.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+      if (it->second == node) {
+        table.erase(it);
+        break;
+      }
+    }
+
+    const_cast<T *>(node)->interned = false;
+  }
+
+protected:
+  /** Take a reference to a node found in the table, unless it's dead. */
+  static bool acquire_live(const T *node)
+  {
+#ifdef THREAD_SAFE_IREP
+    // A node whose last reference was just dropped by another thread is on
+    // its way out of the table, and mustn't be brought back to life.
+    unsigned int count = node->ref_count.load();
+    do {
+      if (count == 0)
+        return false;
+    } while (!node->ref_count.compare_exchange_weak(count, count + 1));
+#else
+    node->ref_count++;
+#endif
+    return true;
+  }
+
+  std::unordered_multimap<size_t, const T *> table;
+#ifdef THREAD_SAFE_IREP
+  std::mutex lock;
+#endif
+};
+
+// The tables are never destroyed: nodes held in other static objects may
+// still be releasing themselves during exit.
+static irep_unique_tablet<type2t> &type_unique_table =
+  *new irep_unique_tablet<type2t>();
+static irep_unique_tablet<expr2t> &expr_unique_table =
+  *new irep_unique_tablet<expr2t>();
+
+type2tc
+hash_cons(const type2tc &type)
+{
+  if (is_nil_type(type) || type->interned)
+    return type;
+
+  // Canonicalize subtypes first, so that comparing against entries in the
+  // table doesn't need to descend any further than this node.
+  bool need_update = false;
+  type->foreach_subtype([&need_update] (const type2tc &t) {
+    if (!is_nil_type(t) && !t->interned)
+      need_update = true;
+  });
+
+  type2tc tmp = type;
+  if (need_update)
+    tmp.get()->Foreach_subtype([] (type2tc &t) { t = hash_cons(t); });
+
+  return type_unique_table.intern(tmp);
+}
+
+expr2tc
+hash_cons(const expr2tc &expr)
+{
+  if (is_nil_expr(expr) || expr->interned)
+    return expr;
+
+  // As with types, operands are made canonical before this node is.
+  bool need_update = !is_nil_type(expr->type) && !expr->type->interned;
+  expr->foreach_operand([&need_update] (const expr2tc &e) {
+    if (!is_nil_expr(e) && !e->interned)
+      need_update = true;
+  });
+
+  expr2tc tmp = expr;
+  if (need_update) {
+    expr2t *e = tmp.get();
+    e->type = hash_cons(e->type);
+    e->Foreach_operand([] (expr2tc &op) { op = hash_cons(op); });
+  }
+
+  return expr_unique_table.intern(tmp);
+}
+
+void
+hash_cons_release(const type2t *type)
+{
+  type_unique_table.release(type);
+}
+
+void
+hash_cons_release(const expr2t *expr)
+{
+  expr_unique_table.release(expr);
+}
+
 // For CRCing to actually be accurate, expr/type ids mustn't overflow out of
 // a byte. If this happens then a) there are too many exprs, and b) the expr
 // crcing code has to change.
@@ -2367,17 +2744,17 @@ size_t
 esbmct::irep_methods2<derived, baseclass, traits, container,  enable, fields>::do_crc() const
 {
 
-  if (this->crc_val != 0)
-    return this->crc_val;
+  size_t crc = this->crc_val.load(std::memory_order_relaxed);
+  if (crc != 0)
+    return crc;
 
   // Starting from 0, pass a crc value through all the sub-fields of this
-  // expression. Store it into crc_val.
-  assert(this->crc_val == 0);
+  // expression. Only store the finished value into crc_val, as other threads
+  // may be looking at it meanwhile.
+  do_crc_rec(crc); // _includes_ type_id / expr_id
 
-  do_crc_rec(); // _includes_ type_id / expr_id
-
-  // Finally, combine the crc of this expr with the input , and return
-  return this->crc_val;
+  this->crc_val.store(crc, std::memory_order_relaxed);
+  return crc;
 }
 
 template <class derived, class baseclass, typename traits, typename container, typename enable, typename fields>
@@ -2444,15 +2821,15 @@ esbmct::irep_methods2<derived, baseclass, traits, container, enable, fields>::lt
 
 template <class derived, class baseclass, typename traits, typename container, typename enable, typename fields>
 void
-esbmct::irep_methods2<derived, baseclass, traits, container, enable, fields>::do_crc_rec() const
+esbmct::irep_methods2<derived, baseclass, traits, container, enable, fields>::do_crc_rec(size_t &crc) const
 {
   const derived *derived_this = static_cast<const derived*>(this);
   auto m_ptr = membr_ptr::value;
 
   size_t tmp = do_type_crc(derived_this->*m_ptr);
-  boost::hash_combine(this->crc_val, tmp);
+  boost::hash_combine(crc, tmp);
 
-  superclass::do_crc_rec();
+  superclass::do_crc_rec(crc);
 }
 
 template <class derived, class baseclass, typename traits, typename container, typename enable, typename fields>
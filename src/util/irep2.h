@@ -25,6 +25,7 @@
 #include <boost/mpl/vector.hpp>
 #include <boost/preprocessor/list/adt.hpp>
 #include <boost/preprocessor/list/for_each.hpp>
+#include <atomic>
 #include <boost/shared_ptr.hpp>
 #include <cstdarg>
 #include <functional>
@@ -163,9 +164,53 @@ class type2t;
 class expr2t;
 class constant_array2t;
 
+/** Node allocator for type2t and expr2t.
+ *  Ireps are small, numerous and short lived. Requests up to a few hundred
+ *  bytes are rounded up to a size class and served from a free list per class,
+ *  refilled a chunk at a time. Freed nodes go back on their class's list and
+ *  are never returned to the system. Larger requests go straight to the global
+ *  heap.
+ *  @param size Size of the object being allocated, as passed to operator new.
+ */
+void *irep_pool_alloc(size_t size);
+/** Return a node to its pool. Size must match that given to irep_pool_alloc.*/
+void irep_pool_free(void *ptr, size_t size);
+
+/** Free list of the nodes of one kind of irep, such as add2t: each concrete
+ *  irep class allocates from its own, so that nodes of one kind sit together
+ *  and a kind's freed nodes are only reused by that kind. Plain data, so it's
+ *  usable before and after static construction and destruction. */
+struct irep_kind_poolt
+{
+  void *free_list;
+};
+
+/** Allocate a node from the pool of its kind. Anything other than the kind's
+ *  own size, which comes of deriving from a concrete irep class, is passed on
+ *  to the size class pools.
+ *  @param kind_size Size of the irep class the pool belongs to.
+ *  @param size Size of the object being allocated. */
+void *irep_pool_alloc(irep_kind_poolt &pool, size_t kind_size, size_t size);
+/** Return a node to the pool of its kind. Arguments must match those given to
+ *  irep_pool_alloc. */
+void irep_pool_free(irep_kind_poolt &pool, size_t kind_size, void *ptr,
+                    size_t size);
+
+/** Per-node bookkeeping. By default ireps are only shared within one thread,
+ *  and this is plain data. Building with THREAD_SAFE_IREP makes it atomic, so
+ *  that nodes can be shared between threads; each thread then also gets its
+ *  own node pool and simplifier memo, and the unique tables are locked. */
+#ifdef THREAD_SAFE_IREP
+typedef std::atomic<unsigned int> irep_ref_countt;
+typedef std::atomic<bool> irep_flagt;
+#else
+typedef unsigned int irep_ref_countt;
+typedef bool irep_flagt;
+#endif
+
 /** Reference counted container for expr2t based classes.
- *  This class extends boost shared_ptr's to contain anything that's a subclass
- *  of expr2t. It provides several ways of accessing the contained pointer;
+ *  This class is a smart pointer to anything that's a subclass of expr2t or
+ *  type2t. It provides several ways of accessing the contained pointer;
  *  crucially it ensures that the only way to get a non-const reference or
  *  pointer is via the get() method, which call the detach() method.
  *
@@ -184,118 +229,231 @@ class constant_array2t;
  *  piece of code modify the duplicate copy, while all the other storage
  *  locations continued to share the original.
  *
- *  So yeah, that's what this class attempts to implement, via the medium of
- *  boosts shared_ptr.
+ *  The reference count lives in the node itself (see type2t::ref_count and
+ *  expr2t::ref_count) and is only atomic when built with THREAD_SAFE_IREP.
+ *  This keeps the container the size of one pointer and avoids a separate
+ *  control block allocation per node.
  */
 template <class T>
-class irep_container : public std::shared_ptr<T>
+class irep_container
 {
 public:
-  irep_container() : std::shared_ptr<T>() {}
+  typedef T element_type;
+
+  irep_container() : ptr(nullptr) {}
 
   template<class Y>
-  explicit irep_container(Y *p) : std::shared_ptr<T>(p)
-    { }
+  explicit irep_container(Y *p) : ptr(p)
+  {
+    acquire();
+  }
 
   template<class Y>
-  explicit irep_container(const Y *p) : std::shared_ptr<T>(const_cast<Y *>(p))
-    { }
+  explicit irep_container(const Y *p) : ptr(const_cast<Y *>(p))
+  {
+    acquire();
+  }
+
+  irep_container(const irep_container &ref) : ptr(ref.ptr)
+  {
+    acquire();
+  }
 
-  irep_container(const irep_container &ref)
-    : std::shared_ptr<T>(ref) {}
+  irep_container(irep_container &&ref) noexcept : ptr(ref.ptr)
+  {
+    ref.ptr = nullptr;
+  }
 
   template <class Y>
   irep_container(const irep_container<Y> &ref)
-    : std::shared_ptr<T>(static_cast<const std::shared_ptr<Y> &>(ref))
+    : ptr(static_cast<T *>(const_cast<Y *>(ref.get())))
+  {
+    acquire();
+  }
+
+  ~irep_container()
   {
-    assert(dynamic_cast<const std::shared_ptr<T> &>(ref) != NULL);
+    release();
   }
 
   irep_container &operator=(irep_container const &ref)
   {
-    std::shared_ptr<T>::operator=(ref);
+    // Take the new reference before dropping the old one, in case the old
+    // node is what keeps the new one alive.
+    irep_container tmp(ref);
+    swap(tmp);
     return *this;
   }
 
-  template<class Y>
-  irep_container & operator=(std::shared_ptr<Y> const & r)
+  irep_container &operator=(irep_container &&ref) noexcept
   {
-    std::shared_ptr<T>::operator=(r);
-    T *p = std::shared_ptr<T>::operator->();
+    swap(ref);
     return *this;
   }
 
   template <class Y>
   irep_container &operator=(const irep_container<Y> &ref)
   {
-    assert(dynamic_cast<const std::shared_ptr<T> &>(ref) != NULL);
-    *this = std::static_pointer_cast<T, Y>
-            (static_cast<const std::shared_ptr<Y> &>(ref));
+    irep_container tmp(ref);
+    swap(tmp);
     return *this;
   }
 
   irep_container simplify() const
   {
-    const T *foo = std::shared_ptr<T>::get();
-    return foo->simplify();
+    return simplify_memoized(*this);
   }
 
   const T &operator*() const
   {
-    return *std::shared_ptr<T>::get();
+    return *ptr;
   }
 
   const T * operator-> () const // never throws
   {
-    return std::shared_ptr<T>::operator->();
+    return ptr;
   }
 
   const T * get() const // never throws
   {
-    return std::shared_ptr<T>::get();
+    return ptr;
   }
 
   T * get() // never throws
   {
     detach();
-    T *tmp = std::shared_ptr<T>::get();
-    tmp->crc_val = 0;
-    return tmp;
+    ptr->invalidate_cached();
+    return ptr;
   }
 
   T * operator-> () // never throws
   {
     detach();
-    T *tmp = std::shared_ptr<T>::get();
-    tmp->crc_val = 0;
-    return tmp;
+    ptr->invalidate_cached();
+    return ptr;
+  }
+
+  explicit operator bool() const
+  {
+    return ptr != nullptr;
+  }
+
+  bool operator==(std::nullptr_t) const
+  {
+    return ptr == nullptr;
+  }
+
+  bool operator!=(std::nullptr_t) const
+  {
+    return ptr != nullptr;
+  }
+
+  long use_count() const
+  {
+    return (ptr) ? (unsigned int)ptr->ref_count : 0;
+  }
+
+  void reset()
+  {
+    release();
+    ptr = nullptr;
+  }
+
+  void swap(irep_container &ref) noexcept
+  {
+    std::swap(ptr, ref.ptr);
   }
 
   void detach()
   {
-    if (this->use_count() == 1)
-      return; // No point remunging oneself if we're the only user of the ptr.
+    if (use_count() == 1) {
+      // No point remunging oneself if we're the only user of the ptr. If it's
+      // a hash-consed node though, it has to leave the unique table before
+      // anyone modifies it, or the table would index it by a stale hash.
+      if (ptr->interned)
+        hash_cons_release(static_cast<const T *>(ptr));
+      // Another thread may have taken it from the table in the meantime.
+      if (use_count() == 1)
+        return;
+    }
 
     // Assign-operate ourself into containing a fresh copy of the data. This
     // creates a new reference counted object, and assigns it to ourself,
     // which causes the existing reference to be decremented.
-    const T *foo = std::shared_ptr<T>::get();
-    *this = foo->clone();
+    *this = static_cast<const T *>(ptr)->clone();
   }
 
   size_t crc() const
   {
-    const T *foo = std::shared_ptr<T>::get();
-    if (foo->crc_val != 0)
-      return foo->crc_val;
+    const T *foo = ptr;
+    size_t crc = foo->crc_val.load(std::memory_order_relaxed);
+    if (crc != 0)
+      return crc;
 
     return foo->do_crc();
   }
+
+protected:
+  void acquire()
+  {
+    if (ptr)
+      ptr->ref_count++;
+  }
+
+  void release()
+  {
+    if (ptr && --ptr->ref_count == 0) {
+      if (ptr->interned)
+        hash_cons_release(static_cast<const T *>(ptr));
+      delete ptr;
+    }
+  }
+
+  T *ptr;
 };
 
 typedef irep_container<type2t> type2tc;
 typedef irep_container<expr2t> expr2tc;
 
+/** Hash-consing of ireps.
+ *  When enabled, every irep built through a something2tc constructor is looked
+ *  up in a global unique table (by hash, then structurally) and the existing
+ *  node is shared instead of keeping a fresh copy. The table doesn't own its
+ *  entries: nodes leave it when the last container lets go of them.
+ *
+ *  Two hash-consed nodes are structurally equal iff they are the same object,
+ *  which turns equality tests between them into pointer comparisons. Nodes
+ *  built in other ways (clone, raw pointers) can still be entered explicitly
+ *  through hash_cons, which also canonicalizes their types and operands.
+ *
+ *  Hash-consed nodes are immutable: taking a non-const reference to one either
+ *  clones it (if shared) or takes it out of the table (if not) first.
+ */
+extern bool irep_hash_consing;
+
+type2tc hash_cons(const type2tc &type);
+expr2tc hash_cons(const expr2tc &expr);
+
+/** Drop a node from the unique table, ahead of it being modified in place. */
+void hash_cons_release(const type2t *type);
+void hash_cons_release(const expr2t *expr);
+
+/** Simplify an expression, remembering the result.
+ *  The simplifier is a pure function of an expression's contents, so results
+ *  are kept in a bounded memo keyed on the expression (by hash, then by
+ *  structure). Expressions that turn out to be fully simplified are also
+ *  flagged as such, so that they're never walked again.
+ *  @see expr2t::simplify
+ *  @return Nil if nothing could be simplified, otherwise the simplified expr.
+ */
+expr2tc simplify_memoized(const expr2tc &expr);
+
+/** Drop every result simplify_memoized has remembered in this thread.
+ *  The memo holds a reference to each expr in it, keeping them alive and
+ *  shared, so it's cleared once a phase that fills it, such as symex, is
+ *  done with it. */
+void simplify_memo_clear();
+
 typedef std::pair<std::string,std::string> member_entryt;
 typedef std::list<member_entryt> list_of_memberst;
 
@@ -345,7 +503,10 @@ protected:
   type2t(type_ids id);
 
   /** Copy constructor */
-  type2t(const type2t &ref) = default;
+  type2t(const type2t &ref);
+
+  /** Assignment: copies contents, but not reference count or table status */
+  type2t &operator=(const type2t &ref);
 
   virtual void foreach_subtype_impl_const(const_subtype_delegate &t) const = 0;
   virtual void foreach_subtype_impl(subtype_delegate &t) = 0;
@@ -357,6 +518,15 @@ public:
 
   virtual ~type2t() = default;
 
+  /** Allocate types out of size-segregated pools rather than the general
+   *  heap; see irep_pool_alloc. Each concrete type class overrides these to
+   *  allocate from a pool of its own, see type_methods2. */
+  static void *operator new(size_t size) { return irep_pool_alloc(size); }
+  static void operator delete(void *ptr, size_t size)
+  {
+    irep_pool_free(ptr, size);
+  }
+
   /** Fetch bit width of this type.
    *  For a particular type, calculate its size in a bit representation of
    *  itself. May throw various exceptions depending on whether this operation
@@ -492,7 +662,22 @@ public:
   // XXX XXX XXX this should be const
   type_ids type_id;
 
-  mutable size_t crc_val;
+  /** Whether this node is the canonical copy in the unique table. */
+  irep_flagt interned;
+
+  /** Number of irep_containers pointing at this type. */
+  mutable irep_ref_countt ref_count;
+
+  /** Hash of this type, or zero if not computed yet. Written once, with the
+   *  finished value, so other threads sharing the node can read it safely. */
+  mutable std::atomic<size_t> crc_val;
+
+  /** Forget anything cached about the contents of this type. Called by
+   *  irep_container when handing out a mutable pointer. */
+  virtual void invalidate_cached()
+  {
+    crc_val.store(0, std::memory_order_relaxed);
+  }
 };
 
 /** Fetch identifying name for a type.
@@ -519,7 +704,7 @@ static inline std::string get_type_id(const type2tc &type)
  *  classes of expr, in addition we have a type as all exprs should have types.
  */
 class expr2t;
-class expr2t : public std::enable_shared_from_this<expr2t>
+class expr2t
 {
 public:
   /** Enumeration identifying each sort of expr.
@@ -561,6 +746,15 @@ public:
 
   virtual ~expr2t() = default;
 
+  /** Allocate exprs out of size-segregated pools rather than the general
+   *  heap; see irep_pool_alloc. Each concrete expr class overrides these to
+   *  allocate from a pool of its own, see expr_methods2. */
+  static void *operator new(size_t size) { return irep_pool_alloc(size); }
+  static void operator delete(void *ptr, size_t size)
+  {
+    irep_pool_free(ptr, size);
+  }
+
   /** Clone method. Self explanatory. */
   virtual expr2tc clone() const = 0;
 
@@ -690,7 +884,8 @@ public:
    *  expression with any calculations or operations that can be simplified,
    *  simplified. In contrast to the old form though, this creates a new expr
    *  if something gets simplified, just to make it clear exactly what's
-   *  going on.
+   *  going on. Operands are simplified through simplify_memoized, and an expr
+   *  that can't be simplified any further is flagged as such.
    *  @return Either a nil expr (null pointer contents) if nothing could be
    *          simplified or a simplified expression.
    */
@@ -761,10 +956,28 @@ public:
   /** Instance of expr_ids recording tihs exprs type. */
   const expr_ids expr_id;
 
+  /** Whether this node is the canonical copy in the unique table. */
+  irep_flagt interned;
+
+  /** Whether the simplifier is known to have nothing to do on this expr. */
+  mutable irep_flagt simplified;
+
+  /** Number of irep_containers pointing at this expr. */
+  mutable irep_ref_countt ref_count;
+
   /** Type of this expr. All exprs have a type. */
   type2tc type;
 
-  mutable size_t crc_val;
+  /** Hash of this expr, or zero if not computed yet; see type2t::crc_val. */
+  mutable std::atomic<size_t> crc_val;
+
+  /** Forget anything cached about the contents of this expr. Called by
+   *  irep_container when handing out a mutable pointer. */
+  void invalidate_cached()
+  {
+    crc_val.store(0, std::memory_order_relaxed);
+    simplified = false;
+  }
 };
 
 inline bool is_nil_expr(const expr2tc &exp)
@@ -1062,7 +1275,7 @@ namespace esbmct {
     void tostring_rec(unsigned int idx, list_of_memberst &vec, unsigned int indent) const;
     bool cmp_rec(const base2t &ref) const;
     int lt_rec(const base2t &ref) const;
-    void do_crc_rec() const;
+    void do_crc_rec(size_t &crc) const;
     void hash_rec(crypto_hash &hash) const;
 
     // These methods are specific to expressions rather than types, and are
@@ -1122,8 +1335,9 @@ namespace esbmct {
       return 0;
     }
 
-    void do_crc_rec() const
+    void do_crc_rec(size_t &crc) const
     {
+      (void)crc;
     }
 
     void hash_rec(crypto_hash &hash) const
@@ -1201,12 +1415,32 @@ namespace esbmct {
     // See notes on irep_methods2 copy constructor
     expr_methods2(const derived &ref) : superclass(ref) { }
 
+    static void *operator new(size_t size)
+    {
+      return irep_pool_alloc(kind_pool(), sizeof(derived), size);
+    }
+    static void operator delete(void *ptr, size_t size)
+    {
+      irep_pool_free(kind_pool(), sizeof(derived), ptr, size);
+    }
+
     const expr2tc *get_sub_expr(unsigned int i) const override;
     expr2tc *get_sub_expr_nc(unsigned int i) override;
     unsigned int get_num_sub_exprs() const override;
 
     void foreach_operand_impl_const(expr2t::const_op_delegate &expr) const override;
     void foreach_operand_impl(expr2t::op_delegate &expr) override;
+
+  protected:
+    /** Free list for this kind of expr; one per thread if they're shared. */
+    static irep_kind_poolt &kind_pool()
+    {
+#ifdef THREAD_SAFE_IREP
+      thread_local
+#endif
+      static irep_kind_poolt pool;
+      return pool;
+    }
   };
 
   /** Type methods template for type ireps.
@@ -1223,8 +1457,28 @@ namespace esbmct {
     // See notes on irep_methods2 copy constructor
     type_methods2(const derived &ref) : superclass(ref) { }
 
+    static void *operator new(size_t size)
+    {
+      return irep_pool_alloc(kind_pool(), sizeof(derived), size);
+    }
+    static void operator delete(void *ptr, size_t size)
+    {
+      irep_pool_free(kind_pool(), sizeof(derived), ptr, size);
+    }
+
     void foreach_subtype_impl_const(type2t::const_subtype_delegate &t) const override;
     void foreach_subtype_impl(type2t::subtype_delegate &t) override;
+
+  protected:
+    /** Free list for this kind of type; one per thread if they're shared. */
+    static irep_kind_poolt &kind_pool()
+    {
+#ifdef THREAD_SAFE_IREP
+      thread_local
+#endif
+      static irep_kind_poolt pool;
+      return pool;
+    }
   };
 
   // So that we can write such things as:
@@ -1293,7 +1547,11 @@ namespace esbmct {
 
     // Forward all constructors down to the contained type.
     template <typename ...Args>
-    something2tc(Args... args) : base2tc(new contained(args...)) { }
+    something2tc(Args... args) : base2tc(new contained(args...))
+    {
+      if (irep_hash_consing)
+        base2tc::operator=(hash_cons(static_cast<const base2tc &>(*this)));
+    }
 
     typedef irep_container<base> base_container;
     typedef idtype id_field_type;
@@ -1316,8 +1574,13 @@ namespace esbmct {
   };
 } // namespace esbmct
 
-// In global namespace: to get boost to recognize something2tc's as being a
-// shared pointer type, we need to define get_pointer for it:
+// In global namespace: to get boost to recognize irep containers as being a
+// smart pointer type, we need to define get_pointer for them:
+
+template <typename T>
+T* get_pointer(irep_container<T> const& p) {
+  return const_cast<T*>(p.get());
+}
 
 template <typename T1, typename T2, unsigned int T3, typename T4, T4 T1::*T5, typename T6>
 T2* get_pointer(esbmct::something2tc<T1, T2, T3, T4, T5, T6> const& p) {
@@ -1326,11 +1589,13 @@ T2* get_pointer(esbmct::something2tc<T1, T2, T3, T4, T5, T6> const& p) {
 
 inline bool operator==(const type2tc &a, const type2tc &b)
 {
-  // Handle nil ireps
-  if (is_nil_type(a) && is_nil_type(b))
+  // Handle nil ireps, and the same node being compared against itself
+  if (a.get() == b.get())
     return true;
   else if (is_nil_type(a) || is_nil_type(b))
     return false;
+  else if (a->interned && b->interned)
+    return false; // Distinct hash-consed nodes always differ
   else
     return (*a.get() == *b.get());
 }
@@ -1342,7 +1607,9 @@ inline bool operator!=(const type2tc &a, const type2tc &b)
 
 inline bool operator<(const type2tc &a, const type2tc &b)
 {
-  if (is_nil_type(a)) // nil is lower than non-nil
+  if (a.get() == b.get())
+    return false; // Identical, or both nil
+  else if (is_nil_type(a)) // nil is lower than non-nil
     return !is_nil_type(b); // true if b is non-nil, so a is lower
   else if (is_nil_type(b))
     return false; // If b is nil, nothing can be lower
@@ -1360,10 +1627,12 @@ inline bool operator>(const type2tc &a, const type2tc &b)
 
 inline bool operator==(const expr2tc& a, const expr2tc& b)
 {
-  if (is_nil_expr(a) && is_nil_expr(b))
-    return true;
+  if (a.get() == b.get())
+    return true; // Same node, or both nil
   else if (is_nil_expr(a) || is_nil_expr(b))
     return false;
+  else if (a->interned && b->interned)
+    return false; // Distinct hash-consed nodes always differ
   else
     return (*a.get() == *b.get());
 }
@@ -1375,7 +1644,9 @@ inline bool operator!=(const expr2tc& a, const expr2tc& b)
 
 inline bool operator<(const expr2tc& a, const expr2tc& b)
 {
-  if (is_nil_expr(a)) // nil is lower than non-nil
+  if (a.get() == b.get())
+    return false; // Identical, or both nil
+  else if (is_nil_expr(a)) // nil is lower than non-nil
     return !is_nil_expr(b); // true if b is non-nil, so a is lower
   else if (is_nil_expr(b))
     return false; // If b is nil, nothing can be lower
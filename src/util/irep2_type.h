@@ -8,6 +8,9 @@
 #ifndef IREP2_TYPE_H_
 #define IREP2_TYPE_H_
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <util/irep2.h>
 
 // Start with forward class definitions
@@ -54,7 +57,27 @@ public:
         member_pretty_names(std::move(pretty_names)), name(n), packed(_packed)
   {
   }
-  struct_union_data(const struct_union_data &ref) = default;
+
+  // The layout isn't copied: another thread may be publishing one on the
+  // original, and copies are generally made to be modified anyway.
+  struct_union_data(const struct_union_data &ref)
+    : type2t(ref), members(ref.members), member_names(ref.member_names),
+      member_pretty_names(ref.member_pretty_names), name(ref.name),
+      packed(ref.packed)
+  {
+  }
+
+  struct_union_data &operator=(const struct_union_data &ref)
+  {
+    type2t::operator=(ref);
+    members = ref.members;
+    member_names = ref.member_names;
+    member_pretty_names = ref.member_pretty_names;
+    name = ref.name;
+    packed = ref.packed;
+    layout.reset();
+    return *this;
+  }
 
   /** Fetch index number of member. Given a textual name of a member of a
    *  struct or union, this method will look up what index it is into the
@@ -69,12 +92,26 @@ public:
   const std::vector<irep_idt> & get_structure_member_names() const;
   const irep_idt & get_structure_name() const;
 
+  void invalidate_cached() override
+  {
+    type2t::invalidate_cached();
+    layout.reset();
+  }
+
   std::vector<type2tc> members;
   std::vector<irep_idt> member_names;
   std::vector<irep_idt> member_pretty_names;
   irep_idt name;
   bool packed;
 
+  /** Byte offset of each member, then the size of the whole thing, filled in
+   *  by type_byte_size and member_offset on first use. Only a prefix of the
+   *  offsets is present if some member has no fixed size. Not part of the
+   *  type's contents: it isn't hashed or compared. A layout is never changed
+   *  once it's been stored here, only replaced, which with THREAD_SAFE_IREP
+   *  is done atomically so that threads sharing the type can fill it in. */
+  mutable std::shared_ptr<const std::vector<BigInt> > layout;
+
 // Type mangling:
   typedef esbmct::field_traits<std::vector<type2tc>, struct_union_data, &struct_union_data::members> members_field;
   typedef esbmct::field_traits<std::vector<irep_idt>, struct_union_data, &struct_union_data::member_names> member_names_field;
@@ -595,18 +632,35 @@ public:
   const type2tc &get_bool() const { return bool_type; }
   const type2tc &get_empty() const { return empty_type; }
 
-  // For other types, have a pool of them for quick lookup.
-  std::map<typet, type2tc> struct_map;
-  std::map<typet, type2tc> union_map;
-  std::map<typet, type2tc> array_map;
-  std::map<typet, type2tc> pointer_map;
-  std::map<typet, type2tc> unsignedbv_map;
-  std::map<typet, type2tc> signedbv_map;
-  std::map<typet, type2tc> fixedbv_map;
-  std::map<typet, type2tc> floatbv_map;
-  std::map<typet, type2tc> string_map;
-  std::map<typet, type2tc> symbol_map;
-  std::map<typet, type2tc> code_map;
+  // For other types, have a pool of them for quick lookup. Keys are compared
+  // in full, comments included, so that a hit is always exactly what
+  // real_migrate_type would have produced.
+  typedef std::unordered_map<irept, type2tc, irep_full_hash, irep_full_eq>
+    type_mapt;
+  type_mapt struct_map;
+  type_mapt union_map;
+  type_mapt array_map;
+  type_mapt pointer_map;
+  type_mapt unsignedbv_map;
+  type_mapt signedbv_map;
+  type_mapt fixedbv_map;
+  type_mapt floatbv_map;
+  type_mapt string_map;
+  type_mapt symbol_map;
+  type_mapt code_map;
+
+  // In front of those, a cache keyed on the identity of the typet's storage,
+  // which spares hashing large struct types on every lookup. Each entry keeps
+  // a copy of its typet, so that the storage can't be reused by another type
+  // while the entry exists.
+  typedef std::unordered_map<const void *, std::pair<irept, const type2tc *> >
+    identity_mapt;
+  identity_mapt identity_map;
+  static const size_t identity_map_limit = 1 << 16;
+
+#ifdef THREAD_SAFE_IREP
+  std::recursive_mutex lock;
+#endif
 
   // And refs to some of those for /really/ quick lookup;
   const type2tc *uint8;
@@ -642,6 +696,9 @@ public:
   const type2tc &get_int16() const { return *int16; }
   const type2tc &get_int32() const { return *int32; }
   const type2tc &get_int64() const { return *int64; }
+
+protected:
+  const type2tc &get_type_from_pool(const typet &val, type_mapt &map);
 };
 
 extern type_poolt type_pool;
@@ -257,7 +257,7 @@ get_base_array_subtype(const type2tc &type)
 
 inline bool simplify(expr2tc &expr)
 {
-  expr2tc tmp = expr->simplify();
+  expr2tc tmp = expr.simplify();
   if (!is_nil_expr(tmp))
   {
     expr = tmp;
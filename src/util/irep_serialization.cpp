@@ -97,17 +97,15 @@ void irep_serializationt::reference_convert(
   const irept &irep,
   std::ostream &out)
 {
-  // Do we have this irep already? Horrible complexity here.
-  unsigned int i;
-  for (i = 0; i < ireps_container.ireps_on_write.size(); i++) {
-    if (full_eq(ireps_container.ireps_on_write[i], irep)) {
-      // Match, at idx i
-      write_long(out, i);
-      return;
-    }
+  // Do we have this irep already?
+  unsigned int i = ireps_container.ireps_on_write.size();
+  auto res = ireps_container.ireps_index.insert(std::make_pair(irep, i));
+  if (!res.second) {
+    // Match, at the recorded index
+    write_long(out, res.first->second);
+    return;
   }
 
-  i = ireps_container.ireps_on_write.size();
   ireps_container.ireps_on_write.push_back(irep);
   write_long(out, i);
   write_irep(out, irep);
@@ -12,6 +12,7 @@ Date: May 2007
 #define IREP_SERIALIZATION_H_
 
 #include <map>
+#include <unordered_map>
 #include <util/hash_cont.h>
 #include <util/irep.h>
 
@@ -66,6 +67,11 @@ public:
 
     typedef std::vector<irept> irepts_on_writet;
     irepts_on_writet ireps_on_write;
+
+    // Position of each irep in ireps_on_write
+    typedef std::unordered_map<irept, unsigned, irep_full_hash,
+                               irep_content_eq> irepts_indext;
+    irepts_indext ireps_index;
     
     typedef std::vector<bool> string_mapt;
     string_mapt string_map;
@@ -76,6 +82,7 @@ public:
     void clear()
     { 
       ireps_on_write.clear(); 
+      ireps_index.clear();
       ireps_on_read.clear();
       string_map.clear();
       string_rev_map.clear();
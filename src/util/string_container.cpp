@@ -13,7 +13,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 string_containert string_container __attribute__((init_priority(101)));
 
-string_ptrt::string_ptrt(const char *_s):s(_s), len(strlen(_s))
+string_ptrt::string_ptrt(const char *_s):
+  s(_s), len(strlen(_s)), hash(hash_string(_s))
 {
 }
 
@@ -24,48 +25,65 @@ bool operator==(const string_ptrt a, const string_ptrt b)
   return memcmp(a.s, b.s, a.len)==0;
 }
 
-unsigned string_containert::get(const char *s)
+string_containert::string_containert():next_no(0)
 {
-  string_ptrt string_ptr(s);
+  for(auto &segment : segments)
+    segment.store(nullptr, std::memory_order_relaxed);
 
-  hash_tablet::iterator it=hash_table.find(string_ptr);
-  
-  if(it!=hash_table.end())
-    return it->second;
-
-  unsigned r=hash_table.size();
-
-  // these are stable
-  string_list.emplace_back(s);
-  string_ptrt result(string_list.back());
+  // allocate empty string -- this gets index 0
+  get(string_ptrt(""));
+}
 
-  hash_table[result]=r;
-  
-  // these are not
-  string_vector.push_back(&string_list.back());
+string_containert::~string_containert()
+{
+  for(auto &segment : segments)
+    delete[] segment.load(std::memory_order_relaxed);
+}
 
-  return r;
+void string_containert::set_string(unsigned no, const std::string *str)
+{
+  size_t n=size_t(no)+first_segment_size;
+  unsigned int top=top_bit(n);
+  std::atomic<const std::string **> &slot=segments[top-first_segment_bits];
+
+  const std::string **segment=slot.load(std::memory_order_acquire);
+  if(segment==nullptr)
+  {
+    // Another shard may be racing to allocate the same segment
+    const std::string **fresh=new const std::string *[size_t(1) << top];
+    if(slot.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel))
+      segment=fresh;
+    else
+      delete[] fresh;
+  }
+
+  segment[n-(size_t(1) << top)]=str;
 }
 
-unsigned string_containert::get(const std::string &s)
+unsigned string_containert::get(const string_ptrt &s)
 {
-  string_ptrt string_ptr(s);
+  shardt &shard=shards[s.hash%num_shards];
+#ifdef THREAD_SAFE_IREP
+  std::lock_guard<std::mutex> guard(shard.lock);
+#endif
 
-  hash_tablet::iterator it=hash_table.find(string_ptr);
+  hash_tablet::iterator it=shard.hash_table.find(s);
   
-  if(it!=hash_table.end())
+  if(it!=shard.hash_table.end())
     return it->second;
 
-  unsigned r=hash_table.size();
+  unsigned r=next_no.fetch_add(1, std::memory_order_relaxed);
 
-  // these are stable
-  string_list.push_back(s);
-  string_ptrt result(string_list.back());
+  shard.string_list.emplace_back(s.s, s.len);
+  const std::string &str=shard.string_list.back();
 
-  hash_table[result]=r;
-  
-  // these are not
-  string_vector.push_back(&string_list.back());
+  // Publish the string under its number before anyone can learn the number:
+  // they'd have to find it in this shard, which means taking the lock.
+  set_string(r, &str);
+
+  string_ptrt key=s;
+  key.s=str.c_str();
+  shard.hash_table[key]=r;
 
   return r;
 }
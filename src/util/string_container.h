@@ -9,8 +9,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef STRING_CONTAINER_H
 #define STRING_CONTAINER_H
 
+#include <atomic>
 #include <cassert>
 #include <list>
+#include <mutex>
 #include <util/hash_cont.h>
 #include <util/string_hash.h>
 #include <vector>
@@ -19,6 +21,7 @@ struct string_ptrt
 {
   const char *s;
   unsigned len;
+  size_t hash;
   
   const char *c_str() const
   {
@@ -27,7 +30,8 @@ struct string_ptrt
   
   explicit string_ptrt(const char *_s);
 
-  explicit string_ptrt(const std::string &_s):s(_s.c_str()), len(_s.size())
+  explicit string_ptrt(const std::string &_s):
+    s(_s.c_str()), len(_s.size()), hash(hash_string(_s))
   {
   }
 
@@ -39,55 +43,80 @@ bool operator==(const string_ptrt a, const string_ptrt b);
 class string_ptr_hash hash_map_hasher_superclass(std::string)
 {
 public:
-  size_t operator()(const string_ptrt s) const { return hash_string(s.s); }
+  size_t operator()(const string_ptrt s) const { return s.hash; }
   bool operator()(const string_ptrt &s1, const string_ptrt &s2) const {
-    return hash_string(s1.s) < hash_string(s2.s);
+    return s1.hash < s2.hash;
   }
 };
 
+/** Interns strings, numbering them in the order they're first seen. Built
+ *  with THREAD_SAFE_IREP, it's safe to use from several threads at once: the
+ *  strings are split over a number of shards by hash, each with its own lock,
+ *  and fetching a string by number takes no lock at all. */
 class string_containert
 {
 public:
   unsigned operator[](const char *s)
   {
-    return get(s);
+    return get(string_ptrt(s));
   }
   
   unsigned operator[](const std::string &s)
   {
-    return get(s);
+    return get(string_ptrt(s));
   }
   
-  string_containert()
-  {
-    // allocate empty string -- this gets index 0
-    get("");
-  }
+  string_containert();
+  ~string_containert();
   
   const char *c_str(unsigned no) const
   {
-    assert(no < string_vector.size());
-    return string_vector[no]->c_str();
+    return get_string(no).c_str();
   }
   
   const std::string &get_string(unsigned no) const
   {
-    assert(no < string_vector.size());
-    return *string_vector[no];
+    assert(no < next_no.load(std::memory_order_relaxed));
+    size_t n = size_t(no) + first_segment_size;
+    unsigned int top = top_bit(n);
+    const std::string *const *segment =
+      segments[top - first_segment_bits].load(std::memory_order_acquire);
+    return *segment[n - (size_t(1) << top)];
   }
 
 protected:
+  unsigned get(const string_ptrt &s);
+
   typedef hash_map_cont<string_ptrt, unsigned, string_ptr_hash> hash_tablet;
-  hash_tablet hash_table;
-  
-  unsigned get(const char *s);
-  unsigned get(const std::string &s);
-  
-  typedef std::list<std::string> string_listt;
-  string_listt string_list;
-  
-  typedef std::vector<std::string *> string_vectort;
-  string_vectort string_vector;
+
+  struct shardt
+  {
+#ifdef THREAD_SAFE_IREP
+    std::mutex lock;
+#endif
+    hash_tablet hash_table;
+    std::list<std::string> string_list; // these are stable
+  };
+
+  static const unsigned int num_shards = 16;
+  shardt shards[num_shards];
+
+  // String numbers index a table of segments, each twice the size of the
+  // previous one. Segments never move once allocated, so readers don't have
+  // to synchronize with threads adding strings.
+  static const unsigned int first_segment_bits = 10;
+  static const size_t first_segment_size = size_t(1) << first_segment_bits;
+  static const unsigned int num_segments = 33 - first_segment_bits;
+
+  static unsigned int top_bit(size_t n)
+  {
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(n);
+  }
+
+  void set_string(unsigned no, const std::string *str);
+
+  std::atomic<const std::string **> segments[num_segments];
+  std::atomic<unsigned> next_no;
 };
 
 extern string_containert string_container;
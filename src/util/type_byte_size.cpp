@@ -46,23 +46,51 @@ round_up_to_int64(mp_integer &mp)
   }
 }
 
-mp_integer
-member_offset(const type2tc &type, const irep_idt &member)
+typedef std::shared_ptr<const std::vector<mp_integer> > struct_layoutt;
+
+static struct_layoutt
+load_struct_layout(const struct_type2t &thetype)
 {
-  mp_integer result = 0;
-  unsigned idx = 0;
+#ifdef THREAD_SAFE_IREP
+  return std::atomic_load(&thetype.layout);
+#else
+  return thetype.layout;
+#endif
+}
 
-  const struct_type2t &thetype = to_struct_type(type);
+static void
+store_struct_layout(const struct_type2t &thetype, struct_layoutt layout)
+{
+#ifdef THREAD_SAFE_IREP
+  std::atomic_store(&thetype.layout, layout);
+#else
+  thetype.layout = layout;
+#endif
+}
 
+/** Lay out the members of a struct, recording each member's offset and then
+ *  the struct's total size in its layout cache, and in out. If some member's
+ *  size can't be computed, the offsets up to and including that member are
+ *  recorded before the exception is passed on. */
+static void
+compute_struct_layout(const struct_type2t &thetype, struct_layoutt &out)
+{
+  std::vector<mp_integer> layout;
+  layout.reserve(thetype.members.size() + 1);
+
+  mp_integer result = 0;
   for(auto const &it : thetype.members)
   {
-    // If the current field is 64 bits, and we're on a 32 bit machine, then we
-    // _must_ round up to 64 bits now. No early padding in packed mode though.
     if (!thetype.packed) {
+      // If the current field is 64 bits, and we're on a 32 bit machine, then
+      // we _must_ round up to 64 bits now. Also guard against symbolic types
+      // as operands.
       if (is_scalar_type(it) && !is_code_type(it) &&
           (it)->get_width() > 32 && config.ansi_c.word_size == 32)
         round_up_to_int64(result);
 
+      // While we're at it, round any struct/union up to 64 bit alignment too,
+      // as that might require such alignment due to internal doubles.
       if (is_structure_type(it))
         round_up_to_int64(result);
 
@@ -73,24 +101,56 @@ member_offset(const type2tc &type, const irep_idt &member)
         round_up_to_int64(result);
     }
 
-    if (thetype.member_names[idx] == member.as_string())
-      break;
+    layout.push_back(result);
 
     // XXX 100% unhandled: bitfields.
 
-    mp_integer sub_size = type_byte_size(it);
+    mp_integer sub_size;
+    try {
+      sub_size = type_byte_size(it);
+    } catch (...) {
+      out = std::make_shared<const std::vector<mp_integer> >(std::move(layout));
+      store_struct_layout(thetype, out);
+      throw;
+    }
+
     // Handle padding: we need to observe the usual struct constraints.
     if (!thetype.packed)
       round_up_to_word(sub_size);
 
     result += sub_size;
-    idx++;
   }
 
-  assert(idx != thetype.members.size() && "Attempted to find member offset of "
-         "member not in a struct");
+  // At the end of that, the tests above should have rounded accumulated size
+  // up to a size that contains the required trailing padding for array
+  // allocation alignment.
+  assert(thetype.packed ||
+         ((result % (config.ansi_c.word_size / 8)) == 0));
+  layout.push_back(result);
 
-  return result;
+  out = std::make_shared<const std::vector<mp_integer> >(std::move(layout));
+  store_struct_layout(thetype, out);
+}
+
+mp_integer
+member_offset(const type2tc &type, const irep_idt &member)
+{
+  const struct_type2t &thetype = to_struct_type(type);
+  unsigned int idx = thetype.get_component_number(member);
+
+  struct_layoutt layout = load_struct_layout(thetype);
+  if (!layout || layout->size() <= idx) {
+    try {
+      compute_struct_layout(thetype, layout);
+    } catch (...) {
+      // Members after this one may have no fixed size, which is fine: only
+      // the offset of this one is needed.
+      if (!layout || layout->size() <= idx)
+        throw;
+    }
+  }
+
+  return (*layout)[idx];
 }
 
 mp_integer
@@ -168,44 +228,13 @@ type_byte_size(const type2tc &type)
     // Compute the size of all members of this struct, and add padding bytes
     // so that they all start on wourd boundries. Also add any trailing bytes
     // necessary to make arrays align properly if malloc'd, see C89 6.3.3.4.
-
+    // The layout is kept on the type, so this only happens once per struct.
     const struct_type2t &t2 = to_struct_type(type);
-    mp_integer accumulated_size(0);
-    for(auto const &it : t2.members)
-    {
-      if (!t2.packed) {
-        // If the current field is 64 bits, and we're on a 32 bit machine, then
-        // we _must_ round up to 64 bits now. Also guard against symbolic types
-        // as operands.
-        if (is_scalar_type(it) && !is_code_type(it) &&
-            (it)->get_width() > 32 && config.ansi_c.word_size == 32)
-          round_up_to_int64(accumulated_size);
-
-        // While we're at it, round any struct/union up to 64 bit alignment too,
-        // as that might require such alignment due to internal doubles.
-        if (is_structure_type(it))
-          round_up_to_int64(accumulated_size);
-
-        // Unions are now being converted to arrays: conservatively round up
-        // all array alignment to 64 bits. This is because we can't easily
-        // work out whether someone is going to store a double into it.
-        if (is_array_type(it))
-          round_up_to_int64(accumulated_size);
-      }
-
-      mp_integer memb_size = type_byte_size(it);
-
-      if (!t2.packed)
-        round_up_to_word(memb_size);
-
-      accumulated_size += memb_size;
-    }
+    struct_layoutt layout = load_struct_layout(t2);
+    if (!layout || layout->size() != t2.members.size() + 1)
+      compute_struct_layout(t2, layout);
 
-    // At the end of that, the tests above should have rounded accumulated size
-    // up to a size that contains the required trailing padding for array
-    // allocation alignment.
-    assert(t2.packed || ((accumulated_size % (config.ansi_c.word_size / 8)) == 0));
-    return accumulated_size;
+    return layout->back();
   }
   case type2t::union_id:
   {